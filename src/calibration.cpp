@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "mca/__mca_internal/single_thread_matrix_calculation.h"
+#include "mca/execution_context.h"
+#include "mca/matrix.h"
+
+namespace mca {
+namespace {
+/* the expected time of a task, it should be much longer than adding and waking a task */
+constexpr double TARGET_TASK_NANOSECONDS = 20000;
+
+/* the shapes of the matrices used in the calibration */
+constexpr size_type CALIBRATION_SIDE                = 128;
+constexpr size_type CALIBRATION_MULTIPLICATION_SIDE = 64;
+
+/* every operation is measured several times, and the fastest one is used */
+constexpr size_type CALIBRATION_REPEAT = 3;
+
+/* call function, then set the grain of op of context so that a task takes TARGET_TASK_NANOSECONDS
+ * calculation is the quantity of the calculation of function */
+template <class T, class Function>
+void measure(ExecutionContext &context,
+             const Operation &op,
+             const size_type &calculation,
+             Function &&function) {
+    using namespace std::chrono;
+    auto best = nanoseconds::max();
+    for (size_type i = 0; i < CALIBRATION_REPEAT; i++) {
+        auto startTime = steady_clock::now();
+        function();
+        best = std::min(best, duration_cast<nanoseconds>(steady_clock::now() - startTime));
+    }
+    // the clock is too coarse, keep the grain derived from limit
+    if (best.count() <= 0) { return; }
+    double grain = TARGET_TASK_NANOSECONDS * static_cast<double>(calculation) /
+                   static_cast<double>(best.count());
+    context.setGrain(op, sizeof(T), std::max<size_type>(1, static_cast<size_type>(grain)));
+}
+
+template <class T>
+void calibrateElementType(ExecutionContext &context) {
+    const Shape shape(CALIBRATION_SIDE, CALIBRATION_SIDE);
+    const Shape multiplicationShape(CALIBRATION_MULTIPLICATION_SIDE,
+                                    CALIBRATION_MULTIPLICATION_SIDE);
+    const size_type size = shape.size();
+    // the elements are all the same, so that no check exits early
+    Matrix<T> a(shape, T(1)), b(shape, T(2)), zero(shape), output(shape);
+    Matrix<T> c(multiplicationShape, T(1)), d(multiplicationShape, T(1));
+    Matrix<T> product(multiplicationShape);
+    const T number(2);
+
+    auto fill = [&output, &size]() {
+        for (size_type i = 0; i < size; i++) { output[i] = T(1); }
+    };
+    auto copy = [&a, &output, &size]() {
+        for (size_type i = 0; i < size; i++) { output[i] = a[i]; }
+    };
+    measure<T>(context, Operation::MATRIX_FILL, size, fill);
+    measure<T>(context, Operation::MATRIX_CONSTRUCT_DIAG, size, fill);
+    measure<T>(context, Operation::MATRIX_CONSTRUCT_IDENTITY, size, fill);
+    measure<T>(context, Operation::MATRIX_COPY_ASSIGNMENT, size, copy);
+    measure<T>(context, Operation::MATRIX_CONSTRUCT_FROM_POINTER, size, copy);
+    measure<T>(context, Operation::MATRIX_CONSTRUCT_FROM_VECTOR, size, copy);
+    measure<T>(context, Operation::MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST, size, copy);
+
+    measure<T>(context, Operation::MATRIX_ADDITION, size, [&]() {
+        addSingleThread(a, b, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_SUBTRACTION, size, [&]() {
+        subtractSingleThread(a, b, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_MULTIPLICATION, c.size() * d.columns(), [&]() {
+        multiplySingleThread(c, d, product, 0, product.size());
+    });
+
+    measure<T>(context, Operation::MATRIX_NUMBER_ADDITION, size, [&]() {
+        addSingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::NUMBER_MATRIX_ADDITION, size, [&]() {
+        addSingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_NUMBER_SUBTRACTION, size, [&]() {
+        subtractSingleThread(a, number, output, 0, size);
+    });
+    measure<T>(context, Operation::NUMBER_MATRIX_SUBTRACTION, size, [&]() {
+        subtractSingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_NUMBER_MULTIPLICATION, size, [&]() {
+        multiplySingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::NUMBER_MATRIX_MULTIPLICATION, size, [&]() {
+        multiplySingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_NUMBER_DIVISION, size, [&]() {
+        divideSingleThread(a, number, output, 0, size);
+    });
+    measure<T>(context, Operation::NUMBER_MATRIX_DIVISION, size, [&]() {
+        divideSingleThread(number, a, output, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_NUMBER_POW, size, [&]() {
+        powNumberSingleThread(a, number, output, 0, size);
+    });
+    measure<T>(context, Operation::NUMBER_MATRIX_POW, size, [&]() {
+        numberPowSingleThread(number, a, output, 0, size);
+    });
+
+    // the results are kept in result, so that the checks will not be optimized out
+    volatile bool result = true;
+    measure<T>(context, Operation::MATRIX_EQUALITY, size, [&]() {
+        result = equalSingleThread(a, a, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_INEQUALITY, size, [&]() {
+        result = notEqualSingleThread(a, b, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_LESS, size, [&]() {
+        result = lessSingleThread(a, b, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_LESS_EQUAL, size, [&]() {
+        result = lessEqualSingleThread(a, b, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_GREATER, size, [&]() {
+        result = greaterSingleThread(b, a, 0, size);
+    });
+    measure<T>(context, Operation::MATRIX_GREATER_EQUAL, size, [&]() {
+        result = greaterEqualSingleThread(b, a, 0, size);
+    });
+    // the checks of symmetry read the pairs of the blocks, but their grains are still of elements
+    const size_type pairNum = transposeBlockPairs<T>(shape.rows).pairNum();
+    measure<T>(context, Operation::MATRIX_SYMMETRIC, size, [&]() {
+        result = symmetricBlockPairsSingleThread(a, 0, pairNum);
+    });
+    measure<T>(context, Operation::MATRIX_ANTISYMMETRIC, size, [&]() {
+        result = antisymmetricBlockPairsSingleThread(zero, 0, pairNum);
+    });
+
+    measure<T>(context, Operation::MATRIX_TRANSPOSE, size, [&]() {
+        transposeSingleThread(a, output, 0, size);
+    });
+}
+}  // namespace
+
+void ExecutionContext::calibrate() {
+    // the matrices used in the calibration are constructed in this context
+    ScopedExecutionContext scope(*this);
+    calibrateElementType<std::int8_t>(*this);
+    calibrateElementType<std::int16_t>(*this);
+    calibrateElementType<float>(*this);
+    calibrateElementType<double>(*this);
+    // long double is as large as double with some compilers
+    if constexpr (sizeof(long double) > sizeof(double)) {
+        calibrateElementType<long double>(*this);
+    }
+}
+}  // namespace mca
@@ -0,0 +1,440 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "mca/__mca_internal/elementwise.h"
+
+#include "simd.h"
+#include "simd_vector.h"
+
+namespace mca {
+namespace {
+#ifdef MCA_SIMD
+/* the element type of a scalar operand, which is one element of the type of the lanes */
+struct ScalarOperand {};
+
+/* load the element of an operand at i in C */
+template <class C, class T>
+inline C loadElement(const void *operand, const std::size_t &i) {
+    if constexpr (std::is_same_v<T, ScalarOperand>) {
+        C value;
+        std::memcpy(&value, operand, sizeof(C));
+        return value;
+    } else {
+        T value;
+        std::memcpy(&value, static_cast<const T *>(operand) + i, sizeof(T));
+        return static_cast<C>(value);
+    }
+}
+
+/* calculate a OP b like a lane of the vectors, the integers wrap around */
+template <ElementwiseOperator OP, class C>
+inline C calculateElement(const C &a, const C &b) {
+    if constexpr (std::is_integral_v<C>) {
+        using U = std::make_unsigned_t<C>;
+        if constexpr (OP == ElementwiseOperator::ADD) { return static_cast<C>(U(a) + U(b)); }
+        if constexpr (OP == ElementwiseOperator::SUBTRACT) { return static_cast<C>(U(a) - U(b)); }
+        if constexpr (OP == ElementwiseOperator::MULTIPLY) { return static_cast<C>(U(a) * U(b)); }
+        if constexpr (OP == ElementwiseOperator::DIVIDE) { return a / b; }
+    } else {
+        if constexpr (OP == ElementwiseOperator::ADD) { return a + b; }
+        if constexpr (OP == ElementwiseOperator::SUBTRACT) { return a - b; }
+        if constexpr (OP == ElementwiseOperator::MULTIPLY) { return a * b; }
+        if constexpr (OP == ElementwiseOperator::DIVIDE) { return a / b; }
+    }
+}
+
+/* calculate the element of output at i one by one */
+template <ElementwiseOperator OP, class C, class X, class Y>
+inline void calculateElementAt(const void *x, const void *y, C *output, const std::size_t &i) {
+    const C value = calculateElement<OP>(loadElement<C, X>(x, i), loadElement<C, Y>(y, i));
+    std::memcpy(output + i, &value, sizeof(C));
+}
+
+/* Calculate output[i] = x[i] OP y[i] with the vectors of Ops, see ElementwiseKernel
+ * X and Y are the element types of the operands, or ScalarOperand
+ * the elements are calculated one by one until output is aligned to a vector,
+ * then the vectors are stored aligned, and the inputs are loaded unaligned,
+ * since they may be at different offsets from the alignment
+ * every element is calculated in the same way, so the result never depends on the alignment */
+#define MCA_DEFINE_ELEMENTWISE_KERNEL(TARGET, NAME)                                         \
+    template <class Ops, ElementwiseOperator OP, class X, class Y>                          \
+    TARGET void NAME(const void *x,                                                         \
+                     const void *y,                                                         \
+                     typename Ops::Type *output,                                            \
+                     const std::size_t &n) {                                                \
+        using C                     = typename Ops::Type;                                   \
+        using Vector                = typename Ops::Vector;                                 \
+        constexpr std::size_t LANES = Ops::LANES;                                           \
+        constexpr bool X_SCALAR     = std::is_same_v<X, ScalarOperand>;                     \
+        constexpr bool Y_SCALAR     = std::is_same_v<Y, ScalarOperand>;                     \
+        std::size_t i               = 0;                                                    \
+        for (; i < n && reinterpret_cast<std::uintptr_t>(output + i) % sizeof(Vector) != 0; \
+             i++) {                                                                         \
+            calculateElementAt<OP, C, X, Y>(x, y, output, i);                               \
+        }                                                                                   \
+        Vector xScalar = Ops::zero(), yScalar = Ops::zero();                                \
+        if constexpr (X_SCALAR) { xScalar = Ops::broadcast(static_cast<const C *>(x)); }    \
+        if constexpr (Y_SCALAR) { yScalar = Ops::broadcast(static_cast<const C *>(y)); }    \
+        for (; i + LANES <= n; i += LANES) {                                                \
+            Vector a = xScalar, b = yScalar;                                                \
+            if constexpr (!X_SCALAR) { a = Ops::load(static_cast<const X *>(x) + i); }      \
+            if constexpr (!Y_SCALAR) { b = Ops::load(static_cast<const Y *>(y) + i); }      \
+            if constexpr (OP == ElementwiseOperator::ADD) {                                 \
+                Ops::storeAligned(output + i, Ops::add(a, b));                              \
+            } else if constexpr (OP == ElementwiseOperator::SUBTRACT) {                     \
+                Ops::storeAligned(output + i, Ops::subtract(a, b));                         \
+            } else if constexpr (OP == ElementwiseOperator::MULTIPLY) {                     \
+                Ops::storeAligned(output + i, Ops::multiply(a, b));                         \
+            } else {                                                                        \
+                Ops::storeAligned(output + i, Ops::divide(a, b));                           \
+            }                                                                               \
+        }                                                                                   \
+        for (; i < n; i++) { calculateElementAt<OP, C, X, Y>(x, y, output, i); }            \
+    }
+
+/* compare x and y like a lane of the vectors, see ComparisonKernel
+ * the unsigned integers are compared as unsigned if UNSIGNED */
+template <ComparisonOperator OP, bool UNSIGNED, class C>
+inline bool compareLanes(const C &x, const C &y, const C &bound) {
+    if constexpr (std::is_floating_point_v<C>) {
+        const C d = x - y;
+        if constexpr (OP == ComparisonOperator::EQUAL) { return !(std::fabs(d) > bound); }
+        if constexpr (OP == ComparisonOperator::NOT_EQUAL) { return !(std::fabs(d) <= bound); }
+        if constexpr (OP == ComparisonOperator::LESS) { return !(d >= -bound); }
+        if constexpr (OP == ComparisonOperator::LESS_EQUAL) { return !(d > bound); }
+        if constexpr (OP == ComparisonOperator::GREATER) { return !(d <= bound); }
+        if constexpr (OP == ComparisonOperator::GREATER_EQUAL) { return !(d < -bound); }
+    } else {
+        using U      = std::conditional_t<UNSIGNED, std::make_unsigned_t<C>, C>;
+        const U a    = static_cast<U>(x), b = static_cast<U>(y);
+        if constexpr (OP == ComparisonOperator::EQUAL) { return a == b; }
+        if constexpr (OP == ComparisonOperator::NOT_EQUAL) { return a != b; }
+        if constexpr (OP == ComparisonOperator::LESS) { return a < b; }
+        if constexpr (OP == ComparisonOperator::LESS_EQUAL) { return a <= b; }
+        if constexpr (OP == ComparisonOperator::GREATER) { return a > b; }
+        if constexpr (OP == ComparisonOperator::GREATER_EQUAL) { return a >= b; }
+    }
+}
+
+/* Check x[i] OP y[i] with the vectors of Ops, see ComparisonKernel
+ * every vector sets the lanes which fail in a mask without branches, the masks are gathered,
+ * and they are tested once after the last vector, then the rest are compared one by one
+ * the floating numbers fail when their difference is out of the bounds like compareLanes(),
+ * which is never true for NaN */
+#define MCA_DEFINE_COMPARISON_KERNEL(TARGET, NAME)                                               \
+    template <class Ops, ComparisonOperator OP, bool UNSIGNED>                                   \
+    TARGET bool NAME(const void *x,                                                              \
+                     const void *y,                                                              \
+                     const std::size_t &n,                                                       \
+                     const typename Ops::Type &bound) {                                          \
+        using C                     = typename Ops::Type;                                        \
+        using Vector                = typename Ops::Vector;                                      \
+        using Operator              = ComparisonOperator;                                        \
+        constexpr std::size_t LANES = Ops::LANES;                                                \
+        const C *p = static_cast<const C *>(x), *q = static_cast<const C *>(y);                  \
+        const C lower               = -bound;                                                    \
+        const Vector upperBound     = Ops::broadcast(&bound);                                    \
+        const Vector lowerBound     = Ops::broadcast(&lower);                                    \
+        typename Ops::Mask failed   = Ops::noMask();                                             \
+        std::size_t i               = 0;                                                         \
+        for (; i + LANES <= n; i += LANES) {                                                     \
+            Vector a = Ops::load(p + i), b = Ops::load(q + i);                                   \
+            if constexpr (std::is_floating_point_v<C>) {                                         \
+                const Vector d = Ops::subtract(a, b);                                            \
+                if constexpr (OP == Operator::EQUAL) {                                           \
+                    failed = Ops::maskOr(failed, Ops::greater(Ops::abs(d), upperBound));         \
+                } else if constexpr (OP == Operator::NOT_EQUAL) {                                \
+                    failed = Ops::maskOr(failed, Ops::greaterEqual(upperBound, Ops::abs(d)));    \
+                } else if constexpr (OP == Operator::LESS) {                                     \
+                    failed = Ops::maskOr(failed, Ops::greaterEqual(d, lowerBound));              \
+                } else if constexpr (OP == Operator::LESS_EQUAL) {                               \
+                    failed = Ops::maskOr(failed, Ops::greater(d, upperBound));                   \
+                } else if constexpr (OP == Operator::GREATER) {                                  \
+                    failed = Ops::maskOr(failed, Ops::greaterEqual(upperBound, d));              \
+                } else {                                                                         \
+                    failed = Ops::maskOr(failed, Ops::greater(lowerBound, d));                   \
+                }                                                                                \
+            } else {                                                                             \
+                if constexpr (UNSIGNED) {                                                        \
+                    a = Ops::flipSign(a);                                                        \
+                    b = Ops::flipSign(b);                                                        \
+                }                                                                                \
+                if constexpr (OP == Operator::EQUAL) {                                           \
+                    failed = Ops::maskOr(failed, Ops::notEqual(a, b));                           \
+                } else if constexpr (OP == Operator::NOT_EQUAL) {                                \
+                    failed = Ops::maskOr(failed, Ops::equal(a, b));                              \
+                } else if constexpr (OP == Operator::LESS) {                                     \
+                    failed = Ops::maskOr(failed, Ops::greaterEqual(a, b));                       \
+                } else if constexpr (OP == Operator::LESS_EQUAL) {                               \
+                    failed = Ops::maskOr(failed, Ops::greater(a, b));                            \
+                } else if constexpr (OP == Operator::GREATER) {                                  \
+                    failed = Ops::maskOr(failed, Ops::greaterEqual(b, a));                       \
+                } else {                                                                         \
+                    failed = Ops::maskOr(failed, Ops::greater(b, a));                            \
+                }                                                                                \
+            }                                                                                    \
+        }                                                                                        \
+        if (Ops::any(failed)) { return false; }                                                  \
+        for (; i < n; i++) {                                                                     \
+            const C xi = loadElement<C, C>(x, i), yi = loadElement<C, C>(y, i);                  \
+            if (!compareLanes<OP, UNSIGNED>(xi, yi, bound)) { return false; }                    \
+        }                                                                                        \
+        return true;                                                                             \
+    }
+
+/* the kernels of an instruction set as the variable templates,
+ * so that the selection below is written once for all of them */
+#define MCA_DEFINE_KERNEL_FAMILY(FAMILY, ELEMENTWISE, COMPARISON)                                \
+    struct FAMILY {                                                                              \
+        template <class Ops, ElementwiseOperator OP, class X, class Y>                           \
+        static constexpr ElementwiseKernel<typename Ops::Type> kernel =                          \
+            ELEMENTWISE<Ops, OP, X, Y>;                                                          \
+        template <class Ops, ComparisonOperator OP, bool UNSIGNED>                               \
+        static constexpr ComparisonKernel<typename Ops::Type> comparison =                       \
+            COMPARISON<Ops, OP, UNSIGNED>;                                                       \
+    };
+
+MCA_DEFINE_ELEMENTWISE_KERNEL(MCA_TARGET_SSE2, sse2Elementwise)
+MCA_DEFINE_ELEMENTWISE_KERNEL(MCA_TARGET_AVX2, avx2Elementwise)
+MCA_DEFINE_ELEMENTWISE_KERNEL(MCA_TARGET_AVX512, avx512Elementwise)
+MCA_DEFINE_COMPARISON_KERNEL(MCA_TARGET_SSE2, sse2Comparison)
+MCA_DEFINE_COMPARISON_KERNEL(MCA_TARGET_AVX2, avx2Comparison)
+MCA_DEFINE_COMPARISON_KERNEL(MCA_TARGET_AVX512, avx512Comparison)
+MCA_DEFINE_KERNEL_FAMILY(Sse2Kernels, sse2Elementwise, sse2Comparison)
+MCA_DEFINE_KERNEL_FAMILY(Avx2Kernels, avx2Elementwise, avx2Comparison)
+MCA_DEFINE_KERNEL_FAMILY(Avx512Kernels, avx512Elementwise, avx512Comparison)
+#undef MCA_DEFINE_ELEMENTWISE_KERNEL
+#undef MCA_DEFINE_COMPARISON_KERNEL
+#undef MCA_DEFINE_KERNEL_FAMILY
+
+/* select the kernel of Family whose first operand is X by the kind of the second one
+ * a widened operand of float or std::int32_t goes with an operand of C or a scalar,
+ * so that there are fewer kernels */
+template <class Family, class Ops, ElementwiseOperator OP, class X>
+ElementwiseKernel<typename Ops::Type> selectSecondOperand(const OperandKind &y) {
+    using C              = typename Ops::Type;
+    constexpr bool WIDEN = std::is_same_v<C, double> &&
+                           (std::is_same_v<X, C> || std::is_same_v<X, ScalarOperand>);
+    switch (y) {
+        case OperandKind::SAME: return Family::template kernel<Ops, OP, X, C>;
+        case OperandKind::SCALAR:
+            if constexpr (!std::is_same_v<X, ScalarOperand>) {
+                return Family::template kernel<Ops, OP, X, ScalarOperand>;
+            }
+            break;
+        case OperandKind::FLOAT:
+            if constexpr (WIDEN) { return Family::template kernel<Ops, OP, X, float>; }
+            break;
+        case OperandKind::INT32:
+            if constexpr (WIDEN) { return Family::template kernel<Ops, OP, X, std::int32_t>; }
+            break;
+        default: break;
+    }
+    return nullptr;
+}
+
+/* select the kernel of Family by the kinds of the operands, see selectSecondOperand() */
+template <class Family, class Ops, ElementwiseOperator OP>
+ElementwiseKernel<typename Ops::Type> selectOperands(const OperandKind &x, const OperandKind &y) {
+    using C             = typename Ops::Type;
+    constexpr bool WIDE = std::is_same_v<C, double>;
+    const bool narrow   = y == OperandKind::SAME || y == OperandKind::SCALAR;
+    switch (x) {
+        case OperandKind::SAME: return selectSecondOperand<Family, Ops, OP, C>(y);
+        case OperandKind::SCALAR: return selectSecondOperand<Family, Ops, OP, ScalarOperand>(y);
+        case OperandKind::FLOAT:
+            if constexpr (WIDE) {
+                if (narrow) { return selectSecondOperand<Family, Ops, OP, float>(y); }
+            }
+            break;
+        case OperandKind::INT32:
+            if constexpr (WIDE) {
+                if (narrow) { return selectSecondOperand<Family, Ops, OP, std::int32_t>(y); }
+            }
+            break;
+        default: break;
+    }
+    return nullptr;
+}
+
+/* select the kernel of Family by the operator and the kinds of the operands
+ * return nullptr if Ops cannot calculate op */
+template <class Family, class Ops>
+ElementwiseKernel<typename Ops::Type> selectKernel(const ElementwiseOperator &op,
+                                                   const OperandKind &x,
+                                                   const OperandKind &y) {
+    switch (op) {
+        case ElementwiseOperator::ADD:
+            return selectOperands<Family, Ops, ElementwiseOperator::ADD>(x, y);
+        case ElementwiseOperator::SUBTRACT:
+            return selectOperands<Family, Ops, ElementwiseOperator::SUBTRACT>(x, y);
+        case ElementwiseOperator::MULTIPLY:
+            if constexpr (Ops::MULTIPLY) {
+                return selectOperands<Family, Ops, ElementwiseOperator::MULTIPLY>(x, y);
+            }
+            break;
+        case ElementwiseOperator::DIVIDE:
+            if constexpr (Ops::DIVIDE) {
+                return selectOperands<Family, Ops, ElementwiseOperator::DIVIDE>(x, y);
+            }
+            break;
+        default: break;
+    }
+    return nullptr;
+}
+
+/* select the comparison kernel of Family by the operator */
+template <class Family, class Ops, bool UNSIGNED>
+ComparisonKernel<typename Ops::Type> selectComparison(const ComparisonOperator &op) {
+    using Operator = ComparisonOperator;
+    switch (op) {
+        case Operator::EQUAL: return Family::template comparison<Ops, Operator::EQUAL, UNSIGNED>;
+        case Operator::NOT_EQUAL:
+            return Family::template comparison<Ops, Operator::NOT_EQUAL, UNSIGNED>;
+        case Operator::LESS: return Family::template comparison<Ops, Operator::LESS, UNSIGNED>;
+        case Operator::LESS_EQUAL:
+            return Family::template comparison<Ops, Operator::LESS_EQUAL, UNSIGNED>;
+        case Operator::GREATER:
+            return Family::template comparison<Ops, Operator::GREATER, UNSIGNED>;
+        case Operator::GREATER_EQUAL:
+            return Family::template comparison<Ops, Operator::GREATER_EQUAL, UNSIGNED>;
+        default: break;
+    }
+    return nullptr;
+}
+
+/* select the comparison kernel of Family by the operator and the signedness,
+ * the floating numbers are always signed */
+template <class Family, class Ops>
+ComparisonKernel<typename Ops::Type> selectComparison(const ComparisonOperator &op,
+                                                      const bool &isUnsigned) {
+    if constexpr (std::is_integral_v<typename Ops::Type>) {
+        if (isUnsigned) { return selectComparison<Family, Ops, true>(op); }
+    }
+    return selectComparison<Family, Ops, false>(op);
+}
+#endif
+}  // namespace
+
+template <>
+ElementwiseKernel<float> elementwiseSimdKernel<float>(const ElementwiseOperator &op,
+                                                      const OperandKind &x,
+                                                      const OperandKind &y) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return selectKernel<Avx512Kernels, Avx512Float>(op, x, y);
+        case InstructionSet::AVX2: return selectKernel<Avx2Kernels, Avx2Float>(op, x, y);
+        case InstructionSet::SSE2: return selectKernel<Sse2Kernels, Sse2Float>(op, x, y);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+ElementwiseKernel<double> elementwiseSimdKernel<double>(const ElementwiseOperator &op,
+                                                        const OperandKind &x,
+                                                        const OperandKind &y) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return selectKernel<Avx512Kernels, Avx512Double>(op, x, y);
+        case InstructionSet::AVX2: return selectKernel<Avx2Kernels, Avx2Double>(op, x, y);
+        case InstructionSet::SSE2: return selectKernel<Sse2Kernels, Sse2Double>(op, x, y);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+ElementwiseKernel<std::int32_t> elementwiseSimdKernel<std::int32_t>(const ElementwiseOperator &op,
+                                                                    const OperandKind &x,
+                                                                    const OperandKind &y) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return selectKernel<Avx512Kernels, Avx512Int32>(op, x, y);
+        case InstructionSet::AVX2: return selectKernel<Avx2Kernels, Avx2Int32>(op, x, y);
+        case InstructionSet::SSE2: return selectKernel<Sse2Kernels, Sse2Int32>(op, x, y);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+// the 64-bit integers have no vectors of SSE2, so they start from AVX2
+template <>
+ElementwiseKernel<std::int64_t> elementwiseSimdKernel<std::int64_t>(const ElementwiseOperator &op,
+                                                                    const OperandKind &x,
+                                                                    const OperandKind &y) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return selectKernel<Avx512Kernels, Avx512Int64>(op, x, y);
+        case InstructionSet::AVX2: return selectKernel<Avx2Kernels, Avx2Int64>(op, x, y);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+ComparisonKernel<float> comparisonSimdKernel<float>(const ComparisonOperator &op,
+                                                    const bool &isUnsigned) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512:
+            return selectComparison<Avx512Kernels, Avx512Float>(op, isUnsigned);
+        case InstructionSet::AVX2: return selectComparison<Avx2Kernels, Avx2Float>(op, isUnsigned);
+        case InstructionSet::SSE2: return selectComparison<Sse2Kernels, Sse2Float>(op, isUnsigned);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+ComparisonKernel<double> comparisonSimdKernel<double>(const ComparisonOperator &op,
+                                                      const bool &isUnsigned) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512:
+            return selectComparison<Avx512Kernels, Avx512Double>(op, isUnsigned);
+        case InstructionSet::AVX2: return selectComparison<Avx2Kernels, Avx2Double>(op, isUnsigned);
+        case InstructionSet::SSE2: return selectComparison<Sse2Kernels, Sse2Double>(op, isUnsigned);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+ComparisonKernel<std::int32_t> comparisonSimdKernel<std::int32_t>(const ComparisonOperator &op,
+                                                                  const bool &isUnsigned) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512:
+            return selectComparison<Avx512Kernels, Avx512Int32>(op, isUnsigned);
+        case InstructionSet::AVX2: return selectComparison<Avx2Kernels, Avx2Int32>(op, isUnsigned);
+        case InstructionSet::SSE2: return selectComparison<Sse2Kernels, Sse2Int32>(op, isUnsigned);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+// SSE2 has no comparison of 64-bit integers, so they start from AVX2
+template <>
+ComparisonKernel<std::int64_t> comparisonSimdKernel<std::int64_t>(const ComparisonOperator &op,
+                                                                  const bool &isUnsigned) {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512:
+            return selectComparison<Avx512Kernels, Avx512Int64>(op, isUnsigned);
+        case InstructionSet::AVX2: return selectComparison<Avx2Kernels, Avx2Int64>(op, isUnsigned);
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+}  // namespace mca
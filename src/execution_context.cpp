@@ -0,0 +1,121 @@
+#include "mca/execution_context.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace mca {
+namespace {
+/* the context installed by the innermost ScopedExecutionContext of the current thread */
+thread_local ExecutionContext *installedContext = nullptr;
+
+/* the first line of the file written by saveGrainTable() */
+const char *const GRAIN_TABLE_HEADER = "mca-grain-table";
+
+constexpr std::size_t GRAIN_TABLE_VERSION = 1;
+
+std::size_t elementSizeClass(const std::size_t &elementSize) {
+    std::size_t result = 0;
+    while (result + 1 < ELEMENT_SIZE_CLASS_NUM && (std::size_t(2) << result) <= elementSize) {
+        result++;
+    }
+    return result;
+}
+}  // namespace
+
+ExecutionContext::ExecutionContext(const size_type &threadNum,
+                                   const size_type &limit,
+                                   const double &eps)
+    : ownedThreadPool(std::make_unique<ThreadPool>(threadNum)),
+      _threadPool(ownedThreadPool.get()),
+      _limit(limit),
+      _eps(eps) {}
+
+ExecutionContext::ExecutionContext(ThreadPool &pool, const size_type &limit, const double &eps)
+    : _threadPool(&pool), _limit(limit), _eps(eps) {}
+
+void ExecutionContext::setThreadNum(const size_type &threadNum) { _threadPool->resize(threadNum); }
+
+void ExecutionContext::setLimit(const size_type &limit) {
+    _limit = std::max<size_type>(1, limit);
+    clearGrainTable();
+}
+
+void ExecutionContext::setGrain(const Operation &op,
+                                const size_type &elementSize,
+                                const size_type &grain) {
+    _grain[static_cast<size_type>(op)][elementSizeClass(elementSize)] = grain;
+}
+
+bool ExecutionContext::saveGrainTable(const std::string &path) const {
+    std::ofstream file(path);
+    file << GRAIN_TABLE_HEADER << ' ' << GRAIN_TABLE_VERSION << ' ' << OPERATION_NUM << ' '
+         << ELEMENT_SIZE_CLASS_NUM << '\n';
+    for (const auto &grains : _grain) {
+        for (size_type i = 0; i < ELEMENT_SIZE_CLASS_NUM; i++) {
+            file << grains[i] << (i + 1 == ELEMENT_SIZE_CLASS_NUM ? '\n' : ' ');
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool ExecutionContext::loadGrainTable(const std::string &path) {
+    std::ifstream file(path);
+    std::string header;
+    size_type version = 0, operationNum = 0, elementSizeClassNum = 0;
+    file >> header >> version >> operationNum >> elementSizeClassNum;
+    // the table of another version or another build can not be used
+    if (!file || header != GRAIN_TABLE_HEADER || version != GRAIN_TABLE_VERSION ||
+        operationNum != OPERATION_NUM || elementSizeClassNum != ELEMENT_SIZE_CLASS_NUM) {
+        return false;
+    }
+    size_type grains[OPERATION_NUM][ELEMENT_SIZE_CLASS_NUM] = {};
+    for (auto &row : grains) {
+        for (auto &grain : row) { file >> grain; }
+    }
+    if (!file) { return false; }
+    std::copy(&grains[0][0], &grains[0][0] + OPERATION_NUM * ELEMENT_SIZE_CLASS_NUM, &_grain[0][0]);
+    return true;
+}
+
+ExecutionContext::size_type ExecutionContext::grain(const Operation &op,
+                                                    const size_type &elementSize) const {
+    size_type result = _grain[static_cast<size_type>(op)][elementSizeClass(elementSize)];
+    if (result != 0) { return result; }
+    switch (op) {
+        case Operation::MATRIX_FILL:
+        case Operation::MATRIX_COPY_ASSIGNMENT:
+        case Operation::MATRIX_CONSTRUCT_DIAG:
+        case Operation::MATRIX_CONSTRUCT_FROM_POINTER:
+        case Operation::MATRIX_CONSTRUCT_FROM_VECTOR:
+        case Operation::MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST:
+        case Operation::MATRIX_CONSTRUCT_IDENTITY:
+            return _limit > std::numeric_limits<size_type>::max() / 8 ?
+                       std::numeric_limits<size_type>::max() :
+                       _limit * 8;
+        case Operation::NUMBER_MATRIX_POW:
+        case Operation::MATRIX_NUMBER_POW: return std::max<size_type>(1, _limit / 8);
+        default: return std::max<size_type>(1, _limit);
+    }
+}
+
+void ExecutionContext::clearGrainTable() {
+    std::fill(&_grain[0][0], &_grain[0][0] + OPERATION_NUM * ELEMENT_SIZE_CLASS_NUM, 0);
+}
+
+ScopedExecutionContext::ScopedExecutionContext(ExecutionContext &context)
+    : previous(installedContext) {
+    installedContext = &context;
+}
+
+ScopedExecutionContext::~ScopedExecutionContext() { installedContext = previous; }
+
+ExecutionContext &defaultContext() {
+    static ExecutionContext context(ThreadPool::getInstance());
+    return context;
+}
+
+ExecutionContext &currentContext() {
+    return installedContext != nullptr ? *installedContext : defaultContext();
+}
+}  // namespace mca
@@ -0,0 +1,119 @@
+#include <cstdint>
+
+#include "mca/__mca_internal/gemm.h"
+
+#include "simd.h"
+#include "simd_vector.h"
+
+namespace mca {
+namespace {
+#ifdef MCA_SIMD
+/* Calculate a MR x NR tile of T with the vectors of Ops, see GemmKernel
+ * a row of the tile has NR / LANES vectors, at most PASS_VECTORS of them are calculated at once,
+ * so that the accumulators of MR rows fit in the registers
+ * every element is summed in the order of k like gemmScalarKernel() */
+#define MCA_DEFINE_GEMM_KERNEL(TARGET, NAME)                                                   \
+    template <class Ops, class T>                                                              \
+    TARGET void NAME(const std::size_t &depth, const T *packedA, const T *packedB, T *tile) { \
+        constexpr std::size_t MR           = GemmBlocking<T>::MR;                              \
+        constexpr std::size_t NR           = GemmBlocking<T>::NR;                              \
+        constexpr std::size_t VECTORS      = NR / Ops::LANES;                                  \
+        constexpr std::size_t PASS_VECTORS = VECTORS < 2 ? VECTORS : 2;                        \
+        static_assert(NR % (Ops::LANES * PASS_VECTORS) == 0);                                  \
+        for (std::size_t pass = 0; pass < VECTORS; pass += PASS_VECTORS) {                     \
+            typename Ops::Vector sum[MR][PASS_VECTORS];                                        \
+            for (std::size_t i = 0; i < MR; i++) {                                             \
+                for (std::size_t v = 0; v < PASS_VECTORS; v++) { sum[i][v] = Ops::zero(); }    \
+            }                                                                                  \
+            const T *a = packedA, *b = packedB + pass * Ops::LANES;                            \
+            for (std::size_t k = 0; k < depth; k++) {                                          \
+                typename Ops::Vector row[PASS_VECTORS];                                        \
+                MCA_UNROLL                                                                     \
+                for (std::size_t v = 0; v < PASS_VECTORS; v++) {                               \
+                    row[v] = Ops::load(b + v * Ops::LANES);                                    \
+                }                                                                              \
+                MCA_UNROLL                                                                     \
+                for (std::size_t i = 0; i < MR; i++) {                                         \
+                    typename Ops::Vector value = Ops::broadcast(a + i);                        \
+                    MCA_UNROLL                                                                 \
+                    for (std::size_t v = 0; v < PASS_VECTORS; v++) {                           \
+                        sum[i][v] = Ops::fma(value, row[v], sum[i][v]);                        \
+                    }                                                                          \
+                }                                                                              \
+                a += MR;                                                                       \
+                b += NR;                                                                       \
+            }                                                                                  \
+            for (std::size_t i = 0; i < MR; i++) {                                             \
+                for (std::size_t v = 0; v < PASS_VECTORS; v++) {                               \
+                    Ops::store(tile + i * NR + (pass + v) * Ops::LANES, sum[i][v]);            \
+                }                                                                              \
+            }                                                                                  \
+        }                                                                                      \
+    }
+
+MCA_DEFINE_GEMM_KERNEL(MCA_TARGET_SSE2, sse2Kernel)
+MCA_DEFINE_GEMM_KERNEL(MCA_TARGET_AVX2, avx2Kernel)
+MCA_DEFINE_GEMM_KERNEL(MCA_TARGET_AVX512, avx512Kernel)
+#undef MCA_DEFINE_GEMM_KERNEL
+#endif
+}  // namespace
+
+const char *gemmInstructionSet() {
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return "avx512";
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+template <>
+GemmKernel<float> gemmSimdKernel<float>() {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return avx512Kernel<Avx512Float, float>;
+        case InstructionSet::AVX2: return avx2Kernel<Avx2Float, float>;
+        case InstructionSet::SSE2: return sse2Kernel<Sse2Float, float>;
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+template <>
+GemmKernel<double> gemmSimdKernel<double>() {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return avx512Kernel<Avx512Double, double>;
+        case InstructionSet::AVX2: return avx2Kernel<Avx2Double, double>;
+        case InstructionSet::SSE2: return sse2Kernel<Sse2Double, double>;
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+// SSE2 has no multiplication of packed 32-bit integers
+template <>
+GemmKernel<std::int32_t> gemmSimdKernel<std::int32_t>() {
+#ifdef MCA_SIMD
+    switch (instructionSet()) {
+        case InstructionSet::AVX512: return avx512Kernel<Avx512Int32, std::int32_t>;
+        case InstructionSet::AVX2: return avx2Kernel<Avx2Int32, std::int32_t>;
+        default: break;
+    }
+#endif
+    return nullptr;
+}
+
+// only AVX-512 has the multiplication of packed 64-bit integers
+template <>
+GemmKernel<std::int64_t> gemmSimdKernel<std::int64_t>() {
+#ifdef MCA_SIMD
+    if (instructionSet() == InstructionSet::AVX512) {
+        return avx512Kernel<Avx512Int64, std::int64_t>;
+    }
+#endif
+    return nullptr;
+}
+}  // namespace mca
@@ -0,0 +1,171 @@
+#ifndef MCA_ASYNC_STATE_H
+#define MCA_ASYNC_STATE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mca/execution_context.h"
+#include "thread_pool.h"
+
+namespace mca {
+/* A continuation of AsyncState::onReady(), which owns its function
+ * unlike std::function, the function may be move-only, e.g. a lambda which captures a unique_ptr */
+class AsyncContinuation {
+public:
+    virtual ~AsyncContinuation() = default;
+
+    virtual void run() = 0;
+};
+
+template <class Function>
+class AsyncContinuationOf : public AsyncContinuation {
+public:
+    template <class F>
+    explicit inline AsyncContinuationOf(F &&function) : function(std::forward<F>(function)) {}
+
+    inline void run() override { function(); }
+
+private:
+    Function function;
+};
+
+/* The shared state of an asynchronous calculation, which is used by mca::async::Future
+ * the calculation runs in the threads of its context, with the context installed
+ * when the context has no thread, the calculation runs in the launching thread */
+template <class T>
+class AsyncState {
+public:
+    /* the type of the stored result, void results are stored as nullptr */
+    using value_type = std::conditional_t<std::is_void_v<T>, std::nullptr_t, T>;
+
+    explicit inline AsyncState(ExecutionContext &context) : context(context) {}
+
+    /* run function in the context of state, and store its result or exception into state */
+    template <class Function>
+    static void launch(const std::shared_ptr<AsyncState> &state, Function &&function);
+
+    /* check if the result or the exception is stored */
+    inline bool ready() const { return done.load(std::memory_order_acquire); }
+
+    /* wait until the result or the exception is stored
+     * a thread of the pool runs the queued tasks until there is none, before it blocks,
+     * so that waiting in a task of the pool does not hold up the calculation */
+    inline void wait() {
+        while (!ready() && context.threadPool().runPendingTask()) {}
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return ready(); });
+    }
+
+    /* wait, then return the result or rethrow the exception */
+    inline value_type &value() {
+        wait();
+        if (exception) { std::rethrow_exception(exception); }
+        return *result;
+    }
+
+    /* call continuation() once the result or the exception is stored
+     * it is called at once in the calling thread if they are already stored,
+     * otherwise it is called in the thread which stores them
+     * continuation is moved into the state, so it may be move-only */
+    template <class Function>
+    inline void onReady(Function &&continuation) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ready()) {
+                using Continuation = AsyncContinuationOf<std::decay_t<Function>>;
+                continuations.emplace_back(
+                    std::make_unique<Continuation>(std::forward<Function>(continuation)));
+                return;
+            }
+        }
+        continuation();
+    }
+
+    inline ExecutionContext &getContext() const { return context; }
+
+private:
+    /* the task of the thread pool, which destroys itself after running */
+    template <class Function>
+    class Task : public ThreadPool::Task {
+    public:
+        template <class F>
+        explicit inline Task(std::shared_ptr<AsyncState> state, F &&function)
+            : state(std::move(state)), function(std::forward<F>(function)) {}
+
+        inline void run() override {
+            std::unique_ptr<Task> self(this);
+            state->execute(function);
+        }
+
+        inline void discard() override {
+            std::unique_ptr<Task> self(this);
+            auto error = std::future_error(std::future_errc::broken_promise);
+            state->finish(std::make_exception_ptr(error));
+        }
+
+    private:
+        std::shared_ptr<AsyncState> state;
+        Function function;
+    };
+
+    template <class Function>
+    inline void execute(Function &function) {
+        ScopedExecutionContext scope(context);
+        try {
+            if constexpr (std::is_void_v<T>) {
+                function();
+                result.emplace(nullptr);
+            } else {
+                result.emplace(function());
+            }
+        } catch (...) {
+            finish(std::current_exception());
+            return;
+        }
+        finish(nullptr);
+    }
+
+    inline void finish(std::exception_ptr error) {
+        std::vector<std::unique_ptr<AsyncContinuation>> readyContinuations;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            exception = std::move(error);
+            done.store(true, std::memory_order_release);
+            readyContinuations.swap(continuations);
+        }
+        condition.notify_all();
+        for (auto &continuation : readyContinuations) { continuation->run(); }
+    }
+
+    ExecutionContext &context;
+    std::atomic<bool> done{false};
+    std::optional<value_type> result;
+    std::exception_ptr exception;
+    std::vector<std::unique_ptr<AsyncContinuation>> continuations;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+template <class T>
+template <class Function>
+void AsyncState<T>::launch(const std::shared_ptr<AsyncState> &state, Function &&function) {
+    if (state->context.threadNum() == 0) {
+        std::decay_t<Function> copy(std::forward<Function>(function));
+        state->execute(copy);
+        return;
+    }
+    state->context.threadPool().addTask(
+        new Task<std::decay_t<Function>>(state, std::forward<Function>(function)));
+}
+}  // namespace mca
+
+#endif
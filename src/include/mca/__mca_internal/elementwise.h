@@ -0,0 +1,197 @@
+#ifndef MCA_ELEMENTWISE_H
+#define MCA_ELEMENTWISE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace mca {
+/* The operators of the element-wise kernels */
+enum class ElementwiseOperator { ADD, SUBTRACT, MULTIPLY, DIVIDE };
+
+/* The kinds of the operands of an element-wise kernel which calculates C
+ * SAME: the elements are C, FLOAT or INT32: the elements are float or std::int32_t,
+ * which are converted into C exactly, SCALAR: one C is used for every element,
+ * NONE: no kernel takes the operand */
+enum class OperandKind { NONE, SAME, FLOAT, INT32, SCALAR };
+
+/* An element-wise kernel calculates output[i] = x[i] op y[i] for every i in [0, n) */
+template <class C>
+using ElementwiseKernel = void (*)(const void *x, const void *y, C *output, const std::size_t &n);
+
+/* The type of the lanes of the SIMD kernels which calculate T, void if there is none
+ * the unsigned integers share the lanes of the signed ones,
+ * whose sums, differences and products are the same bits */
+template <class T>
+using ElementwiseLaneType = std::conditional_t<
+    std::is_same_v<T, float> || std::is_same_v<T, double>,
+    T,
+    std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 4,
+                       std::int32_t,
+                       std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                              sizeof(T) == 8,
+                                          std::int64_t,
+                                          void>>>;
+
+/* Get the SIMD kernel which calculates op of the operands of the kinds x and y in C
+ * the newest one of AVX-512, AVX2 and SSE2 for the running CPU is used
+ * return nullptr if the CPU, the compiler or the instruction set supports none of them,
+ * for example the integers are never divided, and SSE2 does not multiply the 32-bit integers */
+template <class C>
+ElementwiseKernel<C> elementwiseSimdKernel(const ElementwiseOperator &op,
+                                           const OperandKind &x,
+                                           const OperandKind &y);
+template <>
+ElementwiseKernel<float> elementwiseSimdKernel<float>(const ElementwiseOperator &op,
+                                                      const OperandKind &x,
+                                                      const OperandKind &y);
+template <>
+ElementwiseKernel<double> elementwiseSimdKernel<double>(const ElementwiseOperator &op,
+                                                        const OperandKind &x,
+                                                        const OperandKind &y);
+template <>
+ElementwiseKernel<std::int32_t> elementwiseSimdKernel<std::int32_t>(const ElementwiseOperator &op,
+                                                                    const OperandKind &x,
+                                                                    const OperandKind &y);
+template <>
+ElementwiseKernel<std::int64_t> elementwiseSimdKernel<std::int64_t>(const ElementwiseOperator &op,
+                                                                    const OperandKind &x,
+                                                                    const OperandKind &y);
+
+/* A number used for every element by elementwiseSimd() */
+template <class T>
+struct ElementwiseScalar {
+    T value;
+};
+
+/* The element type and the kind of an operand of elementwiseSimd() in a kernel of C */
+template <class Operand, class C>
+struct ElementwiseOperandTraits;
+template <class T, class C>
+struct ElementwiseOperandTraits<const T *, C> {
+    using type = T;
+    static constexpr OperandKind kind =
+        std::is_same_v<ElementwiseLaneType<T>, C> ? OperandKind::SAME
+        : std::is_same_v<C, double> && std::is_same_v<T, float> ? OperandKind::FLOAT
+        : std::is_same_v<C, double> && std::is_integral_v<T> && std::is_signed_v<T> &&
+                sizeof(T) == 4
+            ? OperandKind::INT32
+            : OperandKind::NONE;
+    static inline const void *data(const T *operand) { return operand; }
+};
+template <class T, class C>
+struct ElementwiseOperandTraits<ElementwiseScalar<T>, C> {
+    using type = T;
+    static constexpr OperandKind kind =
+        std::is_same_v<ElementwiseLaneType<T>, C> ? OperandKind::SCALAR : OperandKind::NONE;
+    static inline const void *data(const ElementwiseScalar<T> &operand) { return &operand.value; }
+};
+
+/* Calculate output[i] = x[i] op y[i] for every i in [0, n) with the SIMD kernel,
+ * x and y are the pointers to the elements, or the ElementwiseScalar of the numbers
+ * the result is the same as static_cast<O>(static_cast<CommonType>(x[i]) op
+ * static_cast<CommonType>(y[i])) where CommonType is O, the integers wrap around
+ * return false without calculation if there is no kernel for the types, and the caller
+ * calculates the elements itself */
+template <class X, class Y, class O>
+bool elementwiseSimd(const ElementwiseOperator &op,
+                     const X &x,
+                     const Y &y,
+                     O *output,
+                     const std::size_t &n) {
+    using C = ElementwiseLaneType<O>;
+    if constexpr (!std::is_void_v<C>) {
+        using XTraits = ElementwiseOperandTraits<X, C>;
+        using YTraits = ElementwiseOperandTraits<Y, C>;
+        using Common  = std::common_type_t<typename XTraits::type, typename YTraits::type, O>;
+        if constexpr (std::is_same_v<Common, O> && XTraits::kind != OperandKind::NONE &&
+                      YTraits::kind != OperandKind::NONE) {
+            const ElementwiseKernel<C> kernel =
+                elementwiseSimdKernel<C>(op, XTraits::kind, YTraits::kind);
+            if (kernel != nullptr) {
+                kernel(XTraits::data(x), YTraits::data(y), reinterpret_cast<C *>(output), n);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* The operators of the comparison kernels
+ * the floating numbers compare their difference with epsilon(), see compareElements() */
+enum class ComparisonOperator { EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL };
+
+/* A comparison kernel checks if x[i] op y[i] for every i in [0, n)
+ * the floating numbers compare x[i] - y[i] with bound and -bound, see comparisonBound(),
+ * and the vectors are compared without branches, whose results are checked once at the end */
+template <class C>
+using ComparisonKernel =
+    bool (*)(const void *x, const void *y, const std::size_t &n, const C &bound);
+
+/* Get the SIMD kernel which checks op of the elements of C, the unsigned integers of the size
+ * of C are compared if isUnsigned, see elementwiseSimdKernel()
+ * return nullptr if there is none, for example SSE2 has no comparison of 64-bit integers */
+template <class C>
+ComparisonKernel<C> comparisonSimdKernel(const ComparisonOperator &op, const bool &isUnsigned);
+template <>
+ComparisonKernel<float> comparisonSimdKernel<float>(const ComparisonOperator &op,
+                                                    const bool &isUnsigned);
+template <>
+ComparisonKernel<double> comparisonSimdKernel<double>(const ComparisonOperator &op,
+                                                      const bool &isUnsigned);
+template <>
+ComparisonKernel<std::int32_t> comparisonSimdKernel<std::int32_t>(const ComparisonOperator &op,
+                                                                  const bool &isUnsigned);
+template <>
+ComparisonKernel<std::int64_t> comparisonSimdKernel<std::int64_t>(const ComparisonOperator &op,
+                                                                  const bool &isUnsigned);
+
+/* The bound of the differences of C for eps, which is the largest C not greater than eps,
+ * so that a difference d of C is greater than eps if and only if d > bound,
+ * and it is less than -eps if and only if d < -bound
+ * the integers are compared without eps, so their bound is 0 */
+template <class C>
+C comparisonBound(const double &eps) {
+    if constexpr (std::is_same_v<C, float>) {
+        constexpr float MAX = std::numeric_limits<float>::max();
+        if (std::isnan(eps) || std::isinf(eps)) { return static_cast<float>(eps); }
+        if (eps > MAX) { return MAX; }
+        if (eps < -MAX) { return -std::numeric_limits<float>::infinity(); }
+        const float bound = static_cast<float>(eps);
+        return bound > eps ? std::nextafter(bound, -MAX) : bound;
+    } else if constexpr (std::is_floating_point_v<C>) {
+        return static_cast<C>(eps);
+    } else {
+        return C();
+    }
+}
+
+/* Check if x[i] op y[i] for every i in [0, n) with the SIMD kernel, and store it in result
+ * the elements are compared in their common type with eps like compareElements()
+ * return false without comparison if there is no kernel for the types, and the caller
+ * compares the elements itself */
+template <class T1, class T2>
+bool comparisonSimd(const ComparisonOperator &op,
+                    const T1 *x,
+                    const T2 *y,
+                    const std::size_t &n,
+                    const double &eps,
+                    bool &result) {
+    using Common = std::common_type_t<T1, T2>;
+    using C      = ElementwiseLaneType<Common>;
+    // the conversions into the common type must keep the bits
+    if constexpr (!std::is_void_v<C> && std::is_same_v<ElementwiseLaneType<T1>, C> &&
+                  std::is_same_v<ElementwiseLaneType<T2>, C>) {
+        const ComparisonKernel<C> kernel = comparisonSimdKernel<C>(op, std::is_unsigned_v<Common>);
+        if (kernel != nullptr) {
+            result = kernel(x, y, n, comparisonBound<C>(eps));
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace mca
+
+#endif
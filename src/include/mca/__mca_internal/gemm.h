@@ -0,0 +1,290 @@
+#ifndef MCA_GEMM_H
+#define MCA_GEMM_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "matrix_declaration.h"
+#include "tiling.h"
+
+namespace mca {
+/* The block sizes of the packed matrix multiplication, whose elements are T
+ * the output is calculated by MR x NR tiles, whose accumulators stay in the registers
+ * a KC x NR panel of b stays in L1, a MC x KC block of a stays in L2,
+ * and a KC x NC block of b stays in L3 */
+template <class T>
+struct GemmBlocking {
+    static constexpr std::size_t L1_SIZE = 32 * 1024;
+    static constexpr std::size_t L2_SIZE = 256 * 1024;
+    /* the share of L3 of a thread */
+    static constexpr std::size_t L3_SIZE = 2 * 1024 * 1024;
+
+    static constexpr std::size_t MR = 6;
+    static constexpr std::size_t NR = std::clamp<std::size_t>(64 / sizeof(T), 4, 16);
+    /* every block takes half of its cache, the other half is left for the output and the others */
+    static constexpr std::size_t KC =
+        std::clamp<std::size_t>(L1_SIZE / 2 / (NR * sizeof(T)), 16, 1024);
+    static constexpr std::size_t MC =
+        std::max<std::size_t>(L2_SIZE / 2 / (KC * sizeof(T)) / MR, 1) * MR;
+    static constexpr std::size_t NC =
+        std::max<std::size_t>(L3_SIZE / 2 / (KC * sizeof(T)) / NR, 1) * NR;
+};
+
+/* Get the packing buffer of the calling thread, which has at least size elements
+ * every thread keeps its buffers, so that they are not allocated for every calculation
+ * ID tells the buffers of a and b apart */
+template <class T, std::size_t ID>
+T *gemmBuffer(const std::size_t &size) {
+    thread_local std::vector<T> buffer;
+    if (buffer.size() < size) { buffer.resize(size); }
+    return buffer.data();
+}
+
+/* A micro-kernel calculates a MR x NR tile of T with a packed MR x depth panel of a
+ * and a packed depth x NR panel of b, and stores it row by row into tile */
+template <class T>
+using GemmKernel = void (*)(const std::size_t &depth, const T *packedA, const T *packedB, T *tile);
+
+/* The type of the SIMD micro-kernel which calculates the tiles of T, void if there is none
+ * the integers are chosen by their width, so long and long long share the kernel of 64 bits,
+ * and the unsigned integers share the kernels of the signed ones, whose products are the same bits
+ * like ElementwiseLaneType */
+template <class T>
+struct GemmSimdType {
+    using type = std::conditional_t<
+        std::is_same_v<T, float> || std::is_same_v<T, double>,
+        T,
+        std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 4,
+                           std::int32_t,
+                           std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                                  sizeof(T) == 8,
+                                              std::int64_t,
+                                              void>>>;
+};
+
+/* Get the SIMD micro-kernel of T for the instruction sets of the running CPU,
+ * the newest one of AVX-512, AVX2 + FMA and SSE2 is used
+ * return nullptr if the CPU or the compiler supports none of them,
+ * then gemmScalarKernel() is used
+ * NOTE: the kernels with FMA round once for every multiply-add, so their results may differ
+ *       from gemmScalarKernel()'s in the last bits,
+ *       but the same kernel is used for all the tiles */
+template <class T>
+GemmKernel<T> gemmSimdKernel();
+template <>
+GemmKernel<float> gemmSimdKernel<float>();
+template <>
+GemmKernel<double> gemmSimdKernel<double>();
+template <>
+GemmKernel<std::int32_t> gemmSimdKernel<std::int32_t>();
+template <>
+GemmKernel<std::int64_t> gemmSimdKernel<std::int64_t>();
+
+/* The name of the instruction set of the SIMD micro-kernels:
+ * "avx512", "avx2", "sse2" or "scalar" */
+const char *gemmInstructionSet();
+
+/* The portable micro-kernel, see GemmKernel
+ * every element is summed in the order of k */
+template <class T>
+void gemmScalarKernel(const std::size_t &depth, const T *packedA, const T *packedB, T *tile) {
+    constexpr std::size_t MR = GemmBlocking<T>::MR;
+    constexpr std::size_t NR = GemmBlocking<T>::NR;
+    // the local sums do not alias the panels, so that they can stay in the registers
+    T sum[MR][NR];
+    for (std::size_t i = 0; i < MR; i++) {
+        for (std::size_t j = 0; j < NR; j++) { sum[i][j] = T(); }
+    }
+    for (std::size_t k = 0; k < depth; k++) {
+        for (std::size_t i = 0; i < MR; i++) {
+            const T value = packedA[i];
+            for (std::size_t j = 0; j < NR; j++) { sum[i][j] += value * packedB[j]; }
+        }
+        packedA += MR;
+        packedB += NR;
+    }
+    for (std::size_t i = 0; i < MR; i++) {
+        for (std::size_t j = 0; j < NR; j++) { tile[i * NR + j] = sum[i][j]; }
+    }
+}
+
+/* Pack a[rowBegin:rowBegin+rows, depthBegin:depthBegin+depth] into packed
+ * the rows are grouped by MR, and every group is stored column by column,
+ * the last group is padded with zeros */
+template <class T, class T1>
+void gemmPackA(const Matrix<T1> &a,
+               const std::size_t &rowBegin,
+               const std::size_t &rows,
+               const std::size_t &depthBegin,
+               const std::size_t &depth,
+               T *packed) {
+    constexpr std::size_t MR  = GemmBlocking<T>::MR;
+    const std::size_t columns = a.columns();
+    const T1 *data            = a.data();
+    for (std::size_t i = 0; i < rows; i += MR) {
+        const std::size_t m = std::min(MR, rows - i);
+        for (std::size_t k = 0; k < depth; k++) {
+            const T1 *source = data + (rowBegin + i) * columns + depthBegin + k;
+            for (std::size_t r = 0; r < m; r++) { packed[r] = static_cast<T>(source[r * columns]); }
+            for (std::size_t r = m; r < MR; r++) { packed[r] = T(); }
+            packed += MR;
+        }
+    }
+}
+
+/* Pack b[depthBegin:depthBegin+depth, columnBegin:columnBegin+columns] into packed
+ * the columns are grouped by NR, and every group is stored row by row,
+ * the last group is padded with zeros */
+template <class T, class T2>
+void gemmPackB(const Matrix<T2> &b,
+               const std::size_t &depthBegin,
+               const std::size_t &depth,
+               const std::size_t &columnBegin,
+               const std::size_t &columns,
+               T *packed) {
+    constexpr std::size_t NR  = GemmBlocking<T>::NR;
+    const std::size_t stride  = b.columns();
+    const T2 *data            = b.data();
+    for (std::size_t j = 0; j < columns; j += NR) {
+        const std::size_t n = std::min(NR, columns - j);
+        for (std::size_t k = 0; k < depth; k++) {
+            const T2 *source = data + (depthBegin + k) * stride + columnBegin + j;
+            for (std::size_t c = 0; c < n; c++) { packed[c] = static_cast<T>(source[c]); }
+            for (std::size_t c = n; c < NR; c++) { packed[c] = T(); }
+            packed += NR;
+        }
+    }
+}
+
+/* Store the top-left rows x columns part of a MR x NR tile into target, whose rows are stride apart
+ * if accumulate is true, the tile is added to target, otherwise target is overwritten */
+template <class T, class O>
+void gemmStoreTile(const T *tile,
+                   O *target,
+                   const std::size_t &stride,
+                   const std::size_t &rows,
+                   const std::size_t &columns,
+                   const bool &accumulate) {
+    constexpr std::size_t NR = GemmBlocking<T>::NR;
+    for (std::size_t i = 0; i < rows; i++) {
+        for (std::size_t j = 0; j < columns; j++) {
+            O &element = target[i * stride + j];
+            element    = accumulate ? static_cast<O>(static_cast<T>(element) + tile[i * NR + j])
+                                    : static_cast<O>(tile[i * NR + j]);
+        }
+    }
+}
+
+/* Calculate a * b, and store the result in output
+ * This will only calculate the rectangle output[rowBegin:rowEnd, columnBegin:columnEnd]
+ * the blocks of a and b are converted to the common type of T1, T2 and O when they are packed,
+ * and the tiles are calculated by the SIMD micro-kernel of the common type if there is one
+ * every element is summed in the order of k within the blocks of KC,
+ * so the result does not depend on the rectangle
+ * when O is not the common type and there are several KC blocks, the sums of the blocks are kept
+ * in a buffer of the common type, and they are converted to O once, so the rectangle is calculated
+ * by the strips of MC rows, whose sums fit in the buffer
+ * NOTE: output must not be a or b */
+template <class T1, class T2, class O>
+void gemmSingleThread(const Matrix<T1> &a,
+                      const Matrix<T2> &b,
+                      Matrix<O> &output,
+                      const std::size_t &rowBegin,
+                      const std::size_t &rowEnd,
+                      const std::size_t &columnBegin,
+                      const std::size_t &columnEnd) {
+    assert(rowEnd <= output.rows() && columnEnd <= output.columns());
+    using T        = std::common_type_t<T1, T2, O>;
+    using Blocking = GemmBlocking<T>;
+    if (rowBegin >= rowEnd || columnBegin >= columnEnd) { return; }
+    const std::size_t depth = a.columns();
+    if (depth == 0) {
+        for (std::size_t i = rowBegin; i < rowEnd; i++) {
+            for (std::size_t j = columnBegin; j < columnEnd; j++) { output.get(i, j) = O(); }
+        }
+        return;
+    }
+    if constexpr (!std::is_same_v<O, T>) {
+        if (depth > Blocking::KC && rowEnd - rowBegin > Blocking::MC) {
+            for (std::size_t i = rowBegin; i < rowEnd; i += Blocking::MC) {
+                const std::size_t end = std::min(i + Blocking::MC, rowEnd);
+                gemmSingleThread(a, b, output, i, end, columnBegin, columnEnd);
+            }
+            return;
+        }
+    }
+    using SimdType               = typename GemmSimdType<T>::type;
+    GemmKernel<SimdType> kernel = nullptr;
+    if constexpr (!std::is_void_v<SimdType>) { kernel = gemmSimdKernel<SimdType>(); }
+    T *packedA = gemmBuffer<T, 0>(Blocking::MC * Blocking::KC);
+    T *packedB = gemmBuffer<T, 1>(Blocking::KC * Blocking::NC);
+    // the sums of the strip of rowBegin in the common type, nullptr if output keeps them
+    T *sums = !std::is_same_v<O, T> && depth > Blocking::KC
+                  ? gemmBuffer<T, 2>(Blocking::MC * Blocking::NC)
+                  : nullptr;
+    T tile[Blocking::MR * Blocking::NR];
+    for (std::size_t jc = columnBegin; jc < columnEnd; jc += Blocking::NC) {
+        const std::size_t nc = std::min(Blocking::NC, columnEnd - jc);
+        for (std::size_t pc = 0; pc < depth; pc += Blocking::KC) {
+            const std::size_t kc = std::min(Blocking::KC, depth - pc);
+            gemmPackB(b, pc, kc, jc, nc, packedB);
+            for (std::size_t ic = rowBegin; ic < rowEnd; ic += Blocking::MC) {
+                const std::size_t mc = std::min(Blocking::MC, rowEnd - ic);
+                gemmPackA(a, ic, mc, pc, kc, packedA);
+                for (std::size_t jr = 0; jr < nc; jr += Blocking::NR) {
+                    for (std::size_t ir = 0; ir < mc; ir += Blocking::MR) {
+                        const T *panelA = packedA + ir * kc, *panelB = packedB + jr * kc;
+                        if (kernel != nullptr) {
+                            kernel(kc,
+                                   reinterpret_cast<const SimdType *>(panelA),
+                                   reinterpret_cast<const SimdType *>(panelB),
+                                   reinterpret_cast<SimdType *>(tile));
+                        } else {
+                            gemmScalarKernel(kc, panelA, panelB, tile);
+                        }
+                        const std::size_t rows    = std::min(Blocking::MR, mc - ir);
+                        const std::size_t columns = std::min(Blocking::NR, nc - jr);
+                        if (sums != nullptr) {
+                            T *target = sums + (ic - rowBegin + ir) * Blocking::NC + jr;
+                            gemmStoreTile(tile, target, Blocking::NC, rows, columns, pc != 0);
+                        } else {
+                            O *target = &output.get(ic + ir, jc + jr);
+                            gemmStoreTile(tile, target, output.columns(), rows, columns, pc != 0);
+                        }
+                    }
+                }
+            }
+        }
+        if (sums != nullptr) {
+            for (std::size_t i = rowBegin; i < rowEnd; i++) {
+                const T *source = sums + (i - rowBegin) * Blocking::NC;
+                for (std::size_t j = 0; j < nc; j++) {
+                    output.get(i, jc + j) = static_cast<O>(source[j]);
+                }
+            }
+        }
+    }
+}
+
+/* Partition the rows x columns output of a multiplication of T into at least taskNum tiles
+ * the tiles start as the MC x NC blocks of gemmSingleThread(), so that a tile packs every panel
+ * of a and b once, then they are split until there are enough tiles for the tasks,
+ * but a tile is never smaller than a micro-kernel tile, see partitionTiles() */
+template <class T>
+Tiling gemmTiling(const std::size_t &rows, const std::size_t &columns, const std::size_t &taskNum) {
+    using Blocking = GemmBlocking<T>;
+    return partitionTiles(rows,
+                          columns,
+                          Blocking::MC,
+                          Blocking::NC,
+                          Blocking::MR,
+                          Blocking::NR,
+                          taskNum);
+}
+}  // namespace mca
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef MCA_MATRIX_MULTIPLICATION_H
+#define MCA_MATRIX_MULTIPLICATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "gemm.h"
+#include "matrix_declaration.h"
+#include "mca/execution_context.h"
+#include "mca/shape.h"
+#include "modular_gemm.h"
+#include "operation.h"
+#include "utility.h"
+
+namespace mca {
+/* Calculate a * b with the threads of the current context, and store the result in output
+ * the output is partitioned into 2D tiles, and every task calculates consecutive tiles
+ * NOTE: output must be a.rows() x b.columns(), and it must not be a or b */
+template <class T1, class T2, class O>
+void gemmMultiThread(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output) {
+    using CommonType = std::common_type_t<T1, T2, O>;
+    auto res = threadCalculationTaskNum<CommonType>(Operation::MATRIX_MULTIPLICATION,
+                                                    a.size() * b.columns());
+    const Tiling tiling = gemmTiling<CommonType>(output.rows(), output.columns(), res.taskNum);
+    tileCalculationHelper(Operation::MATRIX_MULTIPLICATION,
+                          tiling,
+                          res,
+                          [&a, &b, &output](const size_t &rowBegin,
+                                            const size_t &rowEnd,
+                                            const size_t &columnBegin,
+                                            const size_t &columnEnd) {
+                              gemmSingleThread(a,
+                                               b,
+                                               output,
+                                               rowBegin,
+                                               rowEnd,
+                                               columnBegin,
+                                               columnEnd);
+                          });
+}
+
+/* Calculate a * b mod the modulus of reduction with the threads of the current context,
+ * and store the result in output, the tiles are the same as gemmMultiThread()'s
+ * NOTE: see gemmModularSingleThread() */
+template <class T1, class T2, class O>
+void gemmModularMultiThread(const Matrix<T1> &a,
+                            const Matrix<T2> &b,
+                            Matrix<O> &output,
+                            const BarrettReduction &reduction) {
+    auto res = threadCalculationTaskNum<std::uint64_t>(Operation::MATRIX_MULTIPLICATION,
+                                                       a.size() * b.columns());
+    const Tiling tiling = gemmTiling<std::uint64_t>(output.rows(), output.columns(), res.taskNum);
+    tileCalculationHelper(Operation::MATRIX_MULTIPLICATION,
+                          tiling,
+                          res,
+                          [&a, &b, &output, &reduction](const size_t &rowBegin,
+                                                        const size_t &rowEnd,
+                                                        const size_t &columnBegin,
+                                                        const size_t &columnEnd) {
+                              gemmModularSingleThread(a,
+                                                      b,
+                                                      output,
+                                                      reduction,
+                                                      rowBegin,
+                                                      rowEnd,
+                                                      columnBegin,
+                                                      columnEnd);
+                          });
+}
+
+/* Call function(i) for every row i in [0, rows) with the threads of the current context */
+template <class Function>
+void strassenParallelRows(const size_type &rows, Function &&function) {
+    ExecutionContext &context = currentContext();
+    const size_type taskNum   = std::min(rows, context.threadNum() + 1);
+    context.threadPool().parallelFor(taskNum, [&rows, &taskNum, &function](const size_type &k) {
+        for (size_type i = k * rows / taskNum; i < (k + 1) * rows / taskNum; i++) { function(i); }
+    });
+}
+
+/* Split the n x n matrix m into the quarters of side x side, padded with zeros,
+ * and call function(x11, x12, x21, x22, values) for every position of the quarters,
+ * where x11, x12, x21, x22 are the elements of the quarters there,
+ * function stores the elements of the 7 outputs there into values
+ * all the outputs are calculated in one pass over m */
+template <class T, class S, class Function>
+void strassenSplit(const Matrix<S> &m,
+                   const size_type &side,
+                   Matrix<T> (&outputs)[7],
+                   Function &&function) {
+    for (auto &output : outputs) { output = Matrix<T>(Shape{side, side}); }
+    const size_type n = m.rows();
+    auto element      = [&m, &n](const size_type &i, const size_type &j) {
+        return i < n && j < n ? static_cast<T>(m.get(i, j)) : T();
+    };
+    strassenParallelRows(side, [&](const size_type &i) {
+        T values[7];
+        for (size_type j = 0; j < side; j++) {
+            function(element(i, j),
+                     element(i, j + side),
+                     element(i + side, j),
+                     element(i + side, j + side),
+                     values);
+            for (size_type k = 0; k < 7; k++) { outputs[k].get(i, j) = values[k]; }
+        }
+    });
+}
+
+/* Calculate a * b of two n x n matrices by Strassen-Winograd, the result is a matrix of T
+ * the matrices are split into the quarters of side ceil(n / 2), padded with zeros,
+ * and the seven products of the quarters are calculated in parallel, recursively
+ * until the side is less than crossover, then gemmMultiThread() is used
+ * the quarters and the sums are built in one pass, and so are the quarters of the result
+ * the recursion only depends on n and crossover, so the result does not depend on the threads
+ * NOTE: crossover must be at least 2 */
+template <class T, class T1, class T2>
+Matrix<T> strassenMultiply(const Matrix<T1> &a, const Matrix<T2> &b, const size_type &crossover) {
+    const size_type n = a.rows();
+    if (n < crossover) {
+        Matrix<T> result(Shape{n, n});
+        gemmMultiThread(a, b, result);
+        return result;
+    }
+    const size_type h = (n + 1) / 2;
+    // left: a11, a12, s4, a22, s1, s2, s3, right: b11, b21, b22, t4, t1, t2, t3
+    Matrix<T> left[7], right[7];
+    strassenSplit(a, h, left, [](const T &a11, const T &a12, const T &a21, const T &a22, T *x) {
+        const T s1 = a21 + a22, s2 = s1 - a11;
+        x[0] = a11, x[1] = a12, x[2] = a12 - s2, x[3] = a22, x[4] = s1, x[5] = s2, x[6] = a11 - a21;
+    });
+    strassenSplit(b, h, right, [](const T &b11, const T &b12, const T &b21, const T &b22, T *x) {
+        const T t1 = b12 - b11, t2 = b22 - t1;
+        x[0] = b11, x[1] = b21, x[2] = b22, x[3] = t2 - b21, x[4] = t1, x[5] = t2, x[6] = b22 - b12;
+    });
+
+    ExecutionContext &context = currentContext();
+    Matrix<T> p[7];
+    context.threadPool().parallelFor(7, [&](const size_type &k) {
+        ScopedExecutionContext scope(context);
+        p[k] = strassenMultiply<T>(left[k], right[k], crossover);
+        left[k]  = Matrix<T>();
+        right[k] = Matrix<T>();
+    });
+
+    Matrix<T> result(Shape{n, n});
+    strassenParallelRows(h, [&](const size_type &i) {
+        for (size_type j = 0; j < h; j++) {
+            const T u2 = p[0].get(i, j) + p[5].get(i, j), u3 = u2 + p[6].get(i, j);
+            result.get(i, j) = p[0].get(i, j) + p[1].get(i, j);
+            if (j + h < n) { result.get(i, j + h) = u2 + p[4].get(i, j) + p[2].get(i, j); }
+            if (i + h < n) {
+                result.get(i + h, j) = u3 - p[3].get(i, j);
+                if (j + h < n) { result.get(i + h, j + h) = u3 + p[4].get(i, j); }
+            }
+        }
+    });
+    return result;
+}
+
+/* Return the crossover of Strassen-Winograd for a * b in T, or 0 if it is not used
+ * the square products of the arithmetic types use it if the options of the current context allow */
+template <class T, class T1, class T2>
+size_type productStrassenCrossover(const Matrix<T1> &a, const Matrix<T2> &b) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        const ExecutionContext &context = currentContext();
+        const size_type crossover       = context.strassenCrossover();
+        if (crossover != 0 && a.square() && b.square() && a.rows() >= crossover &&
+            (!std::is_floating_point_v<T> || context.strassenFloatingPoint())) {
+            return crossover;
+        }
+    }
+    return 0;
+}
+
+/* Calculate a * b of two n x n matrices by Strassen-Winograd, the result is a matrix of T
+ * the signed integers are calculated in the unsigned type of the same width, because the sums
+ * of the quarters may overflow where the product does not, and the wrapped unsigned sums give
+ * the same bits of the product, see strassenMultiply() */
+template <class T, class T1, class T2>
+Matrix<T> strassenProduct(const Matrix<T1> &a, const Matrix<T2> &b, const size_type &crossover) {
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return Matrix<T>(strassenMultiply<std::make_unsigned_t<T>>(a, b, crossover));
+    } else {
+        return strassenMultiply<T>(a, b, crossover);
+    }
+}
+
+/* Calculate a * b, the result is a matrix of T
+ * Strassen-Winograd is used if productStrassenCrossover() allows, otherwise gemmMultiThread() */
+template <class T, class T1, class T2>
+Matrix<T> multiplyMatrix(const Matrix<T1> &a, const Matrix<T2> &b) {
+    const size_type crossover = productStrassenCrossover<T>(a, b);
+    if (crossover != 0) { return strassenProduct<T>(a, b, crossover); }
+    Matrix<T> result(Shape{a.rows(), b.columns()});
+    gemmMultiThread(a, b, result);
+    return result;
+}
+
+/* Calculate a * b in the common type of T1, T2 and O, and store the result in output
+ * gemmMultiThread() writes the product into output without allocation,
+ * and only Strassen-Winograd allocates its own matrices, see multiplyMatrix()
+ * NOTE: output must be a.rows() x b.columns(), and it must not be a or b */
+template <class T1, class T2, class O>
+void multiplyMatrix(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output) {
+    using CommonType          = std::common_type_t<T1, T2, O>;
+    const size_type crossover = productStrassenCrossover<CommonType>(a, b);
+    if (crossover != 0) {
+        output = strassenProduct<CommonType>(a, b, crossover);
+        return;
+    }
+    gemmMultiThread(a, b, output);
+}
+}  // namespace mca
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef MCA_MODULAR_GEMM_H
+#define MCA_MODULAR_GEMM_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "gemm.h"
+#include "matrix_declaration.h"
+
+namespace mca {
+/* The largest modulus of the modular calculation, whose residues are less than 2^32,
+ * so that the product of two residues fits in 64 bits */
+constexpr std::uint64_t MAX_MODULUS = std::uint64_t(1) << 32;
+
+/* Get the high 64 bits of the 128-bit product x * y */
+inline std::uint64_t multiplyHigh(const std::uint64_t &x, const std::uint64_t &y) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(static_cast<unsigned __int128>(x) * y >> 64);
+#else
+    const std::uint64_t xLow = x & 0xFFFFFFFF, xHigh = x >> 32;
+    const std::uint64_t yLow = y & 0xFFFFFFFF, yHigh = y >> 32;
+    const std::uint64_t low = xLow * yLow, middle1 = xHigh * yLow, middle2 = xLow * yHigh;
+    const std::uint64_t carry =
+        ((low >> 32) + (middle1 & 0xFFFFFFFF) + (middle2 & 0xFFFFFFFF)) >> 32;
+    return xHigh * yHigh + (middle1 >> 32) + (middle2 >> 32) + carry;
+#endif
+}
+
+/* The Barrett reduction of the unsigned 64-bit integers modulo modulus, 1 <= modulus <= 2^32
+ * factor is floor((2^64 - 1) / modulus), so the quotient estimated with it is at most
+ * one less than the real one, and one subtraction corrects the remainder
+ * lazyTerms products of two residues can be added to a residue before the sum overflows,
+ * so a dot product is reduced once for every lazyTerms products */
+struct BarrettReduction {
+    std::uint64_t modulus = 1;
+    std::uint64_t factor  = std::numeric_limits<std::uint64_t>::max();
+    std::size_t lazyTerms = std::numeric_limits<std::size_t>::max();
+
+    inline explicit BarrettReduction(const std::uint64_t &m) : modulus(m) {
+        assert(m >= 1 && m <= MAX_MODULUS);
+        constexpr std::uint64_t MAX = std::numeric_limits<std::uint64_t>::max();
+        factor                      = MAX / m;
+        const std::uint64_t product = (m - 1) * (m - 1);
+        if (product != 0) {
+            lazyTerms = static_cast<std::size_t>(
+                std::min<std::uint64_t>((MAX - (m - 1)) / product,
+                                        std::numeric_limits<std::size_t>::max()));
+        }
+    }
+
+    /* get x mod modulus */
+    inline std::uint64_t reduce(const std::uint64_t &x) const {
+        const std::uint64_t remainder = x - multiplyHigh(x, factor) * modulus;
+        return remainder >= modulus ? remainder - modulus : remainder;
+    }
+
+    /* get the residue of value in [0, modulus), the negative integers are reduced upward */
+    template <class T>
+    std::uint64_t residue(const T &value) const {
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                // the magnitude of value, which is also right for the smallest one
+                const std::uint64_t r = reduce(~static_cast<std::uint64_t>(value) + 1);
+                return r == 0 ? 0 : modulus - r;
+            }
+        }
+        return reduce(static_cast<std::uint64_t>(value));
+    }
+};
+
+/* Calculate a * b mod the modulus of reduction, and store the result in output
+ * This will only calculate the rectangle output[rowBegin:rowEnd, columnBegin:columnEnd]
+ * the blocks are packed and the tiles are calculated by the 64-bit integer micro-kernel
+ * like gemmSingleThread(), but a KC block is split into the chunks of lazyTerms,
+ * and every chunk is reduced once and added to the residues of the tile,
+ * so the sums never overflow, and the result is exact
+ * NOTE: the elements of a and b must be the residues in [0, modulus),
+ *       and output must not be a or b */
+template <class T1, class T2, class O>
+void gemmModularSingleThread(const Matrix<T1> &a,
+                             const Matrix<T2> &b,
+                             Matrix<O> &output,
+                             const BarrettReduction &reduction,
+                             const std::size_t &rowBegin,
+                             const std::size_t &rowEnd,
+                             const std::size_t &columnBegin,
+                             const std::size_t &columnEnd) {
+    assert(rowEnd <= output.rows() && columnEnd <= output.columns());
+    using T                  = std::uint64_t;
+    using Blocking           = GemmBlocking<T>;
+    constexpr std::size_t MR = Blocking::MR, NR = Blocking::NR;
+    if (rowBegin >= rowEnd || columnBegin >= columnEnd) { return; }
+    const std::size_t depth = a.columns();
+    if (depth == 0) {
+        for (std::size_t i = rowBegin; i < rowEnd; i++) {
+            for (std::size_t j = columnBegin; j < columnEnd; j++) { output.get(i, j) = O(); }
+        }
+        return;
+    }
+    const GemmKernel<std::int64_t> kernel = gemmSimdKernel<std::int64_t>();
+    const std::size_t chunk               = std::min(Blocking::KC, reduction.lazyTerms);
+    T *packedA = gemmBuffer<T, 0>(Blocking::MC * Blocking::KC);
+    T *packedB = gemmBuffer<T, 1>(Blocking::KC * Blocking::NC);
+    T tile[MR * NR], residues[MR * NR];
+    for (std::size_t jc = columnBegin; jc < columnEnd; jc += Blocking::NC) {
+        const std::size_t nc = std::min(Blocking::NC, columnEnd - jc);
+        for (std::size_t pc = 0; pc < depth; pc += Blocking::KC) {
+            const std::size_t kc = std::min(Blocking::KC, depth - pc);
+            gemmPackB(b, pc, kc, jc, nc, packedB);
+            for (std::size_t ic = rowBegin; ic < rowEnd; ic += Blocking::MC) {
+                const std::size_t mc = std::min(Blocking::MC, rowEnd - ic);
+                gemmPackA(a, ic, mc, pc, kc, packedA);
+                for (std::size_t jr = 0; jr < nc; jr += NR) {
+                    for (std::size_t ir = 0; ir < mc; ir += MR) {
+                        const std::size_t rows    = std::min(MR, mc - ir);
+                        const std::size_t columns = std::min(NR, nc - jr);
+                        for (std::size_t i = 0; i < MR; i++) {
+                            for (std::size_t j = 0; j < NR; j++) {
+                                residues[i * NR + j] =
+                                    pc != 0 && i < rows && j < columns
+                                        ? static_cast<T>(output.get(ic + ir + i, jc + jr + j))
+                                        : T();
+                            }
+                        }
+                        const T *panelA = packedA + ir * kc, *panelB = packedB + jr * kc;
+                        for (std::size_t k = 0; k < kc; k += chunk) {
+                            const std::size_t len = std::min(chunk, kc - k);
+                            if (kernel != nullptr) {
+                                kernel(len,
+                                       reinterpret_cast<const std::int64_t *>(panelA + k * MR),
+                                       reinterpret_cast<const std::int64_t *>(panelB + k * NR),
+                                       reinterpret_cast<std::int64_t *>(tile));
+                            } else {
+                                gemmScalarKernel(len, panelA + k * MR, panelB + k * NR, tile);
+                            }
+                            for (std::size_t e = 0; e < MR * NR; e++) {
+                                residues[e] = reduction.reduce(residues[e] + tile[e]);
+                            }
+                        }
+                        for (std::size_t i = 0; i < rows; i++) {
+                            for (std::size_t j = 0; j < columns; j++) {
+                                output.get(ic + ir + i, jc + jr + j) =
+                                    static_cast<O>(residues[i * NR + j]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+}  // namespace mca
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef MCA_OPERATION_H
+#define MCA_OPERATION_H
+
+#include <cstddef>
+
+namespace mca {
+enum class Operation : unsigned short {
+    MATRIX_ADDITION,
+    MATRIX_SUBTRACTION,
+    MATRIX_MULTIPLICATION,
+
+    NUMBER_MATRIX_ADDITION,
+    NUMBER_MATRIX_SUBTRACTION,
+    NUMBER_MATRIX_MULTIPLICATION,
+    NUMBER_MATRIX_DIVISION,
+    NUMBER_MATRIX_POW,
+
+    MATRIX_NUMBER_ADDITION,
+    MATRIX_NUMBER_SUBTRACTION,
+    MATRIX_NUMBER_MULTIPLICATION,
+    MATRIX_NUMBER_DIVISION,
+    MATRIX_NUMBER_POW,
+
+    MATRIX_EQUALITY,
+    MATRIX_INEQUALITY,
+    MATRIX_LESS,
+    MATRIX_LESS_EQUAL,
+    MATRIX_GREATER,
+    MATRIX_GREATER_EQUAL,
+
+    MATRIX_SYMMETRIC,
+    MATRIX_ANTISYMMETRIC,
+
+    MATRIX_TRANSPOSE,
+    MATRIX_FILL,
+    MATRIX_COPY_ASSIGNMENT,
+    MATRIX_CONSTRUCT_DIAG,
+    MATRIX_CONSTRUCT_FROM_POINTER,
+    MATRIX_CONSTRUCT_FROM_VECTOR,
+    MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST,
+    MATRIX_CONSTRUCT_IDENTITY,
+};
+
+/* The number of the operations */
+inline constexpr std::size_t OPERATION_NUM =
+    static_cast<std::size_t>(Operation::MATRIX_CONSTRUCT_IDENTITY) + 1;
+}  // namespace mca
+
+#endif
@@ -1,12 +1,16 @@
 #ifndef MCA_SINGLE_THREAD_MATRIX_CALCULATION
 #define MCA_SINGLE_THREAD_MATRIX_CALCULATION
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <type_traits>
 
+#include "elementwise.h"
+#include "gemm.h"
 #include "matrix_declaration.h"
 #include "mca/mca_config.h"
+#include "transpose.h"
 #include "utility.h"
 
 namespace mca {
@@ -53,63 +57,76 @@ void powNumberSingleThread(const Matrix<T> &a,
 /* Check if the elements of the sub-matrix of a are all less than the sub-matrix of b's
  * This will only check the a[pos:pos+len] with b[pos:pos+len]
  * pos: one-demensional starting index of the matrix
- * len: number of elements to be checked */
+ * len: number of elements to be checked
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool lessSingleThread(const Matrix<T1> &a,
                       const Matrix<T2> &b,
                       const std::size_t &pos,
-                      const std::size_t &len);
+                      const std::size_t &len,
+                      const std::atomic<bool> *stop = nullptr);
 
 /* Check if the elements of the sub-matrix of a are all equal to the sub-matrix of b's
- * This will only check the a[pos:pos+len] with b[pos:pos+len] */
+ * This will only check the a[pos:pos+len] with b[pos:pos+len]
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool equalSingleThread(const Matrix<T1> &a,
                        const Matrix<T2> &b,
                        const std::size_t &pos,
-                       const std::size_t &len);
+                       const std::size_t &len,
+                       const std::atomic<bool> *stop = nullptr);
 
 /* Check if the elements of the sub-matrix of a are all less than or equal to the sub-matrix of
  * This will only check the a[pos:pos+len] with b[pos:pos+len]
  * pos: one-demensional starting index of the matrix
- * len: number of elements to be checked */
+ * len: number of elements to be checked
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool lessEqualSingleThread(const Matrix<T1> &a,
                            const Matrix<T2> &b,
                            const std::size_t &pos,
-                           const std::size_t &len);
+                           const std::size_t &len,
+                           const std::atomic<bool> *stop = nullptr);
 
 /* Check if the elements of the sub-matrix of a are all greater than the sub-matrix of b's
  * This will only check the a[pos:pos+len] with b[pos:pos+len]
  * pos: one-demensional starting index of the matrix
- * len: number of elements to be checked */
+ * len: number of elements to be checked
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool greaterSingleThread(const Matrix<T1> &a,
                          const Matrix<T2> &b,
                          const std::size_t &pos,
-                         const std::size_t &len);
+                         const std::size_t &len,
+                         const std::atomic<bool> *stop = nullptr);
 
 /* Check if the elements of the sub-matrix of a are all greater than or equal to the sub-matrix of
  * b's This will only check the a[pos:pos+len] with
- * b[pos:pos+len] */
+ * b[pos:pos+len]
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool greaterEqualSingleThread(const Matrix<T1> &a,
                               const Matrix<T2> &b,
                               const std::size_t &pos,
-                              const std::size_t &len);
+                              const std::size_t &len,
+                              const std::atomic<bool> *stop = nullptr);
 
 /* Check if any element of the sub-matrix of a is not equal to the sub-matrix of b's
  * This will only check the a[pos:pos+len] with
- * b[pos:pos+len] */
+ * b[pos:pos+len]
+ * stop: the check gives up and returns false once *stop is true */
 template <class T1, class T2>
 bool notEqualSingleThread(const Matrix<T1> &a,
                           const Matrix<T2> &b,
                           const std::size_t &pos,
-                          const std::size_t &len);
+                          const std::size_t &len,
+                          const std::atomic<bool> *stop = nullptr);
 
 /* Calculate a + b, and store the result in output
  * This will only calculate the a+b[pos:pos+len]
  * pos: start position
  * len: length of calculation
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output and b
  *       the matrix which will be calculated must in range
  * for example: a = [[-1, -2, -3],
@@ -131,6 +148,7 @@ void addSingleThread(const Matrix<T1> &a,
  * This will only calculate the a-b[pos:pos+len]
  * pos: start position
  * len: length of calculation
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output and b
  *       the matrix which will be calculated must in range
  * for example: a = [[-1, -2, -3],
@@ -152,8 +170,9 @@ void subtractSingleThread(const Matrix<T1> &a,
  * This will only calculate the a*b[pos:pos+len]
  * pos: start position
  * len: length of calculation
- * NOTE: a must have the same shape with output and b
- *       &a must not be equal to &output
+ * the rows are calculated by the blocked and packed multiplication in gemm.h
+ * NOTE: a.columns() must be equal to b.rows(), and output must be a.rows() x b.columns()
+ *       &a and &b must not be equal to &output
  *       the matrix which will be calculated must in range */
 template <class T1, class T2, class O>
 void multiplySingleThread(const Matrix<T1> &a,
@@ -166,6 +185,7 @@ void multiplySingleThread(const Matrix<T1> &a,
  * This will only calculate the number+a[pos:pos+len]
  * pos: one-demensional starting index of the matrix
  * len: number of elements to be calculated
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -185,6 +205,7 @@ void addSingleThread(const Number &number,
  * This will only calculate the number-a[pos:pos+len]
  * pos: one-demensional starting index of the matrix
  * len: number of elements to be calculated
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -204,6 +225,7 @@ void subtractSingleThread(const Number &number,
  * This will only calculate the a[pos:pos+len]-number
  * pos: one-demensional starting index of the matrix
  * len: number of elements to be calculated
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -223,6 +245,7 @@ void subtractSingleThread(const Matrix<T> &a,
  * This will only calculate the number*a[pos:pos+len]
  * pos: one-demensional starting index of the matrix
  * len: number of elements to be calculated
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -242,6 +265,7 @@ void multiplySingleThread(const Number &number,
  * This will only calculate the a[pos:pos+len]/number
  * pos: one-demensional starting index of the matrix
  * len: number of elements to be calculated
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -261,6 +285,7 @@ void divideSingleThread(const Matrix<T> &a,
  * This will only calculate the number+a[sx:sx+shape.rows][sy:sy+shape+shape.columns]
  * pos: the frist position of matrix a
  * len: length of elements
+ * the elements are calculated by the SIMD kernels in elementwise.h if there is one for the types
  * NOTE: a must have the same shape with output
  *       the matrix which will be calculated must in range
  * for example: number = 2,
@@ -302,6 +327,7 @@ void transposeSingleThread(const Matrix<T> &a,
  * This will only check the a[pos:pos+len]
  * pos: the frist position of matrix a
  * len: length of elements
+ * stop: the check gives up and returns false once *stop is true
  * for example: a = [[1, 2, 3],
  *                   [2, 3, 4],
  *                   [3, 6, 5]]
@@ -309,12 +335,16 @@ void transposeSingleThread(const Matrix<T> &a,
  *              len = 2
  *              return: true */
 template <class T>
-bool symmetricSingleThread(const Matrix<T> &a, const std::size_t &pos, const std::size_t &len);
+bool symmetricSingleThread(const Matrix<T> &a,
+                           const std::size_t &pos,
+                           const std::size_t &len,
+                           const std::atomic<bool> *stop = nullptr);
 
 /* Check whether or not a is antisymmetric
  * This will only check the a[pos:pos+len]
  * pos: the frist position of matrix a
  * len: length of elements
+ * stop: the check gives up and returns false once *stop is true
  * for example: a = [[1,  2, 3],
  *                   [2,  3, 4],
  *                   [3, -4, 5]]
@@ -322,7 +352,31 @@ bool symmetricSingleThread(const Matrix<T> &a, const std::size_t &pos, const std
  *              len = 1
  *              return: true */
 template <class T>
-bool antisymmetricSingleThread(const Matrix<T> &a, const std::size_t &pos, const std::size_t &len);
+bool antisymmetricSingleThread(const Matrix<T> &a,
+                               const std::size_t &pos,
+                               const std::size_t &len,
+                               const std::atomic<bool> *stop = nullptr);
+
+/* Check whether or not a is symmetric in the pairs of the blocks [pos, pos + len)
+ * only the strict upper triangle of the pairs is read, together with its mirror,
+ * see allOfMirroredElements()
+ * pos: the first pair of transposeBlockPairs<T>(a.rows())
+ * len: number of the pairs
+ * stop: the check gives up and returns false once *stop is true
+ * NOTE: a must be a square matrix */
+template <class T>
+bool symmetricBlockPairsSingleThread(const Matrix<T> &a,
+                                     const std::size_t &pos,
+                                     const std::size_t &len,
+                                     const std::atomic<bool> *stop = nullptr);
+
+/* Check whether or not a is antisymmetric in the pairs of the blocks [pos, pos + len)
+ * see symmetricBlockPairsSingleThread() */
+template <class T>
+bool antisymmetricBlockPairsSingleThread(const Matrix<T> &a,
+                                         const std::size_t &pos,
+                                         const std::size_t &len,
+                                         const std::atomic<bool> *stop = nullptr);
 
 // Those below are the implementations
 template <class Number, class T, class O, class>
@@ -355,130 +409,110 @@ void powNumberSingleThread(const Matrix<T> &a,
     }
 }
 
-template <class T1, class T2>
-bool lessSingleThread(const Matrix<T1> &a,
-                      const Matrix<T2> &b,
-                      const std::size_t &pos,
-                      const std::size_t &len) {
+/* Check if x op y, the floating numbers compare x - y with eps, and they are equal when the
+ * difference is not greater than eps, so that x < y when x - y < -eps for example */
+template <ComparisonOperator OP, class T>
+inline bool compareElements(const T &x, const T &y, const double &eps) {
+    if constexpr (std::is_floating_point_v<T>) {
+        const T d = x - y;
+        if constexpr (OP == ComparisonOperator::EQUAL) { return !(std::fabs(d) > eps); }
+        if constexpr (OP == ComparisonOperator::NOT_EQUAL) { return !(std::fabs(d) <= eps); }
+        if constexpr (OP == ComparisonOperator::LESS) { return !(d >= -eps); }
+        if constexpr (OP == ComparisonOperator::LESS_EQUAL) { return !(d > eps); }
+        if constexpr (OP == ComparisonOperator::GREATER) { return !(d <= eps); }
+        if constexpr (OP == ComparisonOperator::GREATER_EQUAL) { return !(d < -eps); }
+    } else {
+        if constexpr (OP == ComparisonOperator::EQUAL) { return x == y; }
+        if constexpr (OP == ComparisonOperator::NOT_EQUAL) { return x != y; }
+        if constexpr (OP == ComparisonOperator::LESS) { return x < y; }
+        if constexpr (OP == ComparisonOperator::LESS_EQUAL) { return x <= y; }
+        if constexpr (OP == ComparisonOperator::GREATER) { return x > y; }
+        if constexpr (OP == ComparisonOperator::GREATER_EQUAL) { return x >= y; }
+    }
+}
+
+/* Check if a[i] OP b[i] for every i in [pos, pos + len) in the common type, see compareElements()
+ * the blocks of allOfBlocksSingleThread() are compared by the SIMD kernels in elementwise.h
+ * if there is one for the types, otherwise element by element */
+template <ComparisonOperator OP, class T1, class T2>
+bool compareSingleThread(const Matrix<T1> &a,
+                         const Matrix<T2> &b,
+                         const std::size_t &pos,
+                         const std::size_t &len,
+                         const std::atomic<bool> *stop) {
     assert(a.shape() == b.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i]) >= -epsilon()) {
-            return false;
+    const double eps = epsilon();
+    auto compare     = [&a, &b, &eps](const std::size_t &begin, const std::size_t &end) {
+        bool result = true;
+        if (comparisonSimd(OP, a.data() + begin, b.data() + begin, end - begin, eps, result)) {
+            return result;
         }
-        if (!std::is_floating_point_v<CommonType> &&
-            (static_cast<CommonType>(a[i]) >= static_cast<CommonType>(b[i]))) {
-            return false;
+        for (std::size_t i = begin; i < end; i++) {
+            if (!compareElements<OP>(static_cast<CommonType>(a[i]),
+                                     static_cast<CommonType>(b[i]),
+                                     eps)) {
+                return false;
+            }
         }
-    }
-    return true;
+        return true;
+    };
+    return allOfBlocksSingleThread(pos, len, stop, compare);
+}
+
+template <class T1, class T2>
+bool lessSingleThread(const Matrix<T1> &a,
+                      const Matrix<T2> &b,
+                      const std::size_t &pos,
+                      const std::size_t &len,
+                      const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::LESS>(a, b, pos, len, stop);
 }
 
 template <class T1, class T2>
 bool equalSingleThread(const Matrix<T1> &a,
                        const Matrix<T2> &b,
                        const std::size_t &pos,
-                       const std::size_t &len) {
-    assert(a.shape() == b.shape());
-    assert(pos + len <= a.size());
-    using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            std::fabs(static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i])) > epsilon()) {
-            return false;
-        }
-        if (!std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) != static_cast<CommonType>(b[i])) {
-            return false;
-        }
-    }
-    return true;
+                       const std::size_t &len,
+                       const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::EQUAL>(a, b, pos, len, stop);
 }
 
 template <class T1, class T2>
 bool lessEqualSingleThread(const Matrix<T1> &a,
                            const Matrix<T2> &b,
                            const std::size_t &pos,
-                           const std::size_t &len) {
-    assert(a.shape() == b.shape());
-    assert(pos + len <= a.size());
-    using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i]) > epsilon()) {
-            return false;
-        }
-        if (!std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) > static_cast<CommonType>(b[i])) {
-            return false;
-        }
-    }
-    return true;
+                           const std::size_t &len,
+                           const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::LESS_EQUAL>(a, b, pos, len, stop);
 }
 
 template <class T1, class T2>
 bool greaterSingleThread(const Matrix<T1> &a,
                          const Matrix<T2> &b,
                          const std::size_t &pos,
-                         const std::size_t &len) {
-    assert(a.shape() == b.shape());
-    assert(pos + len <= a.size());
-    using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i]) <= epsilon()) {
-            return false;
-        }
-        if (!std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) <= static_cast<CommonType>(b[i])) {
-            return false;
-        }
-    }
-    return true;
+                         const std::size_t &len,
+                         const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::GREATER>(a, b, pos, len, stop);
 }
 
 template <class T1, class T2>
 bool greaterEqualSingleThread(const Matrix<T1> &a,
                               const Matrix<T2> &b,
                               const std::size_t &pos,
-                              const std::size_t &len) {
-    assert(a.shape() == b.shape());
-    assert(pos + len <= a.size());
-    using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i]) < -epsilon()) {
-            return false;
-        }
-        if (!std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) < static_cast<CommonType>(b[i])) {
-            return false;
-        }
-    }
-    return true;
+                              const std::size_t &len,
+                              const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::GREATER_EQUAL>(a, b, pos, len, stop);
 }
 
 template <class T1, class T2>
 bool notEqualSingleThread(const Matrix<T1> &a,
                           const Matrix<T2> &b,
                           const std::size_t &pos,
-                          const std::size_t &len) {
-    assert(a.shape() == b.shape());
-    assert(pos + len <= a.size());
-    using CommonType = std::common_type_t<T1, T2>;
-    for (std::size_t i = pos; i < pos + len; i++) {
-        if (std::is_floating_point_v<CommonType> &&
-            std::fabs(static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i])) <= epsilon()) {
-            return false;
-        }
-        if (!std::is_floating_point_v<CommonType> &&
-            static_cast<CommonType>(a[i]) == static_cast<CommonType>(b[i])) {
-            return false;
-        }
-    }
-    return true;
+                          const std::size_t &len,
+                          const std::atomic<bool> *stop) {
+    return compareSingleThread<ComparisonOperator::NOT_EQUAL>(a, b, pos, len, stop);
 }
 
 template <class Number, class T, class O, class>
@@ -490,6 +524,13 @@ void multiplySingleThread(const Number &number,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::MULTIPLY,
+                        a.data() + pos,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++)
         output[i] = static_cast<O>(static_cast<CommonType>(a[i]) * static_cast<CommonType>(number));
 }
@@ -504,6 +545,13 @@ void addSingleThread(const Matrix<T1> &a,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<T1, T2, O>;
+    if (elementwiseSimd(ElementwiseOperator::ADD,
+                        a.data() + pos,
+                        b.data() + pos,
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++) {
         output[i] = static_cast<O>(static_cast<CommonType>(a[i]) + static_cast<CommonType>(b[i]));
     }
@@ -518,6 +566,13 @@ void subtractSingleThread(const Matrix<T1> &a,
     assert(a.shape() == b.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<T1, T2, O>;
+    if (elementwiseSimd(ElementwiseOperator::SUBTRACT,
+                        a.data() + pos,
+                        b.data() + pos,
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++) {
         output[i] = static_cast<O>(static_cast<CommonType>(a[i]) - static_cast<CommonType>(b[i]));
     }
@@ -530,24 +585,30 @@ void multiplySingleThread(const Matrix<T1> &a,
                           const std::size_t &pos,
                           const std::size_t &len) {
     assert(reinterpret_cast<const void *>(&a) != reinterpret_cast<const void *>(&output));
+    assert(reinterpret_cast<const void *>(&b) != reinterpret_cast<const void *>(&output));
     assert(a.columns() == b.rows());
     assert(a.rows() == output.rows());
     assert(b.columns() == output.columns());
     assert(pos + len <= output.size());
-    using CommonType = std::common_type_t<T1, T2, O>;
-    std::size_t i = 0, j = 0;
-    for (std::size_t t = pos; t < pos + len; t++) {
-        i                = t / output.columns();
-        j                = t % output.columns();
-        output.get(i, j) = O();
-        for (std::size_t k = 0; k < a.columns(); k++) {
-            // clang-format off
-            output.get(i, j) = static_cast<O>(static_cast<CommonType>(output.get(i, j)) +
-                                              static_cast<CommonType>(a.get(i, k)) *
-                                              static_cast<CommonType>(b.get(k, j)));
-            // clang-format on
-        }
+    const std::size_t columns = output.columns();
+    if (len == 0) { return; }
+    // the range is split into a partial first row, the full rows and a partial last row
+    const std::size_t firstRow    = pos / columns, lastRow = (pos + len - 1) / columns;
+    const std::size_t firstColumn = pos % columns, lastColumn = (pos + len - 1) % columns + 1;
+    if (firstRow == lastRow) {
+        gemmSingleThread(a, b, output, firstRow, firstRow + 1, firstColumn, lastColumn);
+        return;
     }
+    std::size_t rowBegin = firstRow, rowEnd = lastRow + 1;
+    if (firstColumn != 0) {
+        gemmSingleThread(a, b, output, firstRow, firstRow + 1, firstColumn, columns);
+        rowBegin++;
+    }
+    if (lastColumn != columns) {
+        gemmSingleThread(a, b, output, lastRow, lastRow + 1, 0, lastColumn);
+        rowEnd--;
+    }
+    gemmSingleThread(a, b, output, rowBegin, rowEnd, 0, columns);
 }
 
 template <class Number, class T, class O, class>
@@ -559,6 +620,13 @@ void addSingleThread(const Number &number,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::ADD,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        a.data() + pos,
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++)
         output[i] = static_cast<O>(static_cast<CommonType>(number) + static_cast<CommonType>(a[i]));
 }
@@ -572,6 +640,13 @@ void subtractSingleThread(const Number &number,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::SUBTRACT,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        a.data() + pos,
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++)
         output[i] = static_cast<O>(static_cast<CommonType>(number) - static_cast<CommonType>(a[i]));
 }
@@ -585,6 +660,13 @@ void subtractSingleThread(const Matrix<T> &a,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::SUBTRACT,
+                        a.data() + pos,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++)
         output[i] = static_cast<O>(static_cast<CommonType>(a[i]) - static_cast<CommonType>(number));
 }
@@ -598,6 +680,13 @@ void divideSingleThread(const Matrix<T> &a,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::DIVIDE,
+                        a.data() + pos,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++)
         output[i] = static_cast<O>(static_cast<CommonType>(a[i]) / static_cast<CommonType>(number));
 }
@@ -611,6 +700,13 @@ void divideSingleThread(const Number &number,
     assert(a.shape() == output.shape());
     assert(pos + len <= a.size());
     using CommonType = std::common_type_t<Number, T, O>;
+    if (elementwiseSimd(ElementwiseOperator::DIVIDE,
+                        ElementwiseScalar<CommonType>{static_cast<CommonType>(number)},
+                        a.data() + pos,
+                        output.data() + pos,
+                        len)) {
+        return;
+    }
     for (std::size_t i = pos; i < pos + len; i++) {
         output[i] = static_cast<O>(static_cast<CommonType>(number) / static_cast<CommonType>(a[i]));
     }
@@ -625,50 +721,102 @@ void transposeSingleThread(const Matrix<T> &a,
     assert(a.rows() == output.columns());
     assert(a.columns() == output.rows());
     assert(pos + len <= output.size());
-    std::size_t i = 0, j = 0;
-    for (std::size_t t = pos; t < pos + len; t++) {
-        i                = t / output.columns();
-        j                = t % output.columns();
-        output.get(i, j) = a.get(j, i);
+    const std::size_t columns = output.columns();
+    if (len == 0) { return; }
+    // the range is split into a partial first row, the full rows and a partial last row,
+    // the rows of output are the columns of a
+    const std::size_t firstRow    = pos / columns, lastRow = (pos + len - 1) / columns;
+    const std::size_t firstColumn = pos % columns, lastColumn = (pos + len - 1) % columns + 1;
+    if (firstRow == lastRow) {
+        transposeBlocked(a, output, firstColumn, lastColumn, firstRow, firstRow + 1);
+        return;
+    }
+    std::size_t rowBegin = firstRow, rowEnd = lastRow + 1;
+    if (firstColumn != 0) {
+        transposeBlocked(a, output, firstColumn, columns, firstRow, firstRow + 1);
+        rowBegin++;
+    }
+    if (lastColumn != columns) {
+        transposeBlocked(a, output, 0, lastColumn, lastRow, lastRow + 1);
+        rowEnd--;
+    }
+    transposeBlocked(a, output, 0, columns, rowBegin, rowEnd);
+}
+
+/* Check if x and y, which are mirrored across the diagonal, are equal
+ * the floating numbers are equal when their difference is not greater than eps */
+template <class T>
+inline bool symmetricElements(const T &x, const T &y, const double &eps) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return !(fabs(x - y) > eps);
+    } else {
+        return !(x != y);
+    }
+}
+
+/* Check if x and y, which are mirrored across the diagonal, are opposite
+ * the floating numbers are opposite when their sum is not greater than eps */
+template <class T>
+inline bool antisymmetricElements(const T &x, const T &y, const double &eps) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return !(fabs(x + y) > eps);
+    } else {
+        return !(x != -y);
     }
 }
 
 template <class T>
-bool symmetricSingleThread(const Matrix<T> &a, const std::size_t &pos, const std::size_t &len) {
+bool symmetricSingleThread(const Matrix<T> &a,
+                           const std::size_t &pos,
+                           const std::size_t &len,
+                           const std::atomic<bool> *stop) {
     assert(a.rows() == a.columns());
     assert(pos + len <= a.size());
-    std::size_t i = 0, j = 0;
-    for (std::size_t t = pos; t < pos + len; t++) {
-        i = t / a.columns();
-        j = t % a.columns();
-        if (i == j) {
-            continue;
-        } else if (std::is_floating_point_v<T> && fabs(a.get(i, j) - a.get(j, i)) > epsilon()) {
-            return false;
-        } else if (!std::is_floating_point_v<T> && a.get(i, j) != a.get(j, i)) {
-            return false;
-        }
-    }
-    return true;
+    const double eps = epsilon();
+    return allOfSingleThread(pos, len, stop, [&a, &eps](const std::size_t &t) {
+        std::size_t i = t / a.columns(), j = t % a.columns();
+        return i == j || symmetricElements(a.get(i, j), a.get(j, i), eps);
+    });
 }
 
 template <class T>
-bool antisymmetricSingleThread(const Matrix<T> &a, const std::size_t &pos, const std::size_t &len) {
+bool antisymmetricSingleThread(const Matrix<T> &a,
+                               const std::size_t &pos,
+                               const std::size_t &len,
+                               const std::atomic<bool> *stop) {
     assert(a.rows() == a.columns());
     assert(pos + len <= a.size());
-    std::size_t i = 0, j = 0;
-    for (std::size_t t = pos; t < pos + len; t++) {
-        i = t / a.columns();
-        j = t % a.columns();
-        if (i == j) {
-            continue;
-        } else if (std::is_floating_point_v<T> && fabs(a.get(i, j) + a.get(j, i)) > epsilon()) {
-            return false;
-        } else if (!std::is_floating_point_v<T> && a.get(i, j) != -a.get(j, i)) {
-            return false;
-        }
-    }
-    return true;
+    const double eps = epsilon();
+    return allOfSingleThread(pos, len, stop, [&a, &eps](const std::size_t &t) {
+        std::size_t i = t / a.columns(), j = t % a.columns();
+        return i == j || antisymmetricElements(a.get(i, j), a.get(j, i), eps);
+    });
+}
+
+template <class T>
+bool symmetricBlockPairsSingleThread(const Matrix<T> &a,
+                                     const std::size_t &pos,
+                                     const std::size_t &len,
+                                     const std::atomic<bool> *stop) {
+    assert(a.rows() == a.columns());
+    assert(pos + len <= transposeBlockPairs<T>(a.rows()).pairNum());
+    const double eps = epsilon();
+    return allOfMirroredElements(a, pos, len, stop, [&eps](const T &x, const T &y) {
+        return symmetricElements(x, y, eps);
+    });
+}
+
+template <class T>
+bool antisymmetricBlockPairsSingleThread(const Matrix<T> &a,
+                                         const std::size_t &pos,
+                                         const std::size_t &len,
+                                         const std::atomic<bool> *stop) {
+    assert(a.rows() == a.columns());
+    assert(pos + len <= transposeBlockPairs<T>(a.rows()).pairNum());
+    const double eps = epsilon();
+    return allOfMirroredElements(a, pos, len, stop, [&eps](const T &x, const T &y) {
+        return antisymmetricElements(x, y, eps);
+    });
 }
 }  // namespace mca
 #endif
@@ -1,45 +1,75 @@
 #ifndef MCA_THREAD_POOL_H
 #define MCA_THREAD_POOL_H
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
 #include <cstddef>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
+
+#include "work_stealing_queue.h"
 
 namespace mca {
-/* the class is not thread-safe
- * synchronizations are needed when more than one thread operate the same object of the class */
+/* addTask() and resize() are thread-safe, any number of threads can add tasks at the same time,
+ * even when the thread pool is being resized
+ * clear() is not thread-safe,
+ * it must not be called when other threads are operating the same object of the class */
 class ThreadPool {
 public:
     using size_type = std::size_t;
 
-    /* get the instance of the thread pool */
+    /* the unit of work of the thread pool
+     * run() will be called once when a thread picks the task up,
+     * discard() will be called instead when the task is removed without running */
+    class Task {
+    public:
+        virtual ~Task() = default;
+
+        virtual void run() = 0;
+
+        virtual void discard() = 0;
+    };
+
+    /* create a thread pool of size threads */
+    explicit inline ThreadPool(size_type size = 0) { resize(size); }
+
+    /* get the shared instance of the thread pool */
     inline static ThreadPool &getInstance(size_type size = 0) {
         static ThreadPool instance;
         instance.resize(size);
         return instance;
     }
 
-    /* the copy constructor and assignment operator are deleted
-     * to avoid multiple instances of the thread pool */
+    /* the copy constructor and assignment operator are deleted */
     ThreadPool(const ThreadPool &)             = delete;
     ThreadPool(const ThreadPool &&)            = delete;
     ThreadPool &operator=(const ThreadPool &)  = delete;
     ThreadPool &operator=(const ThreadPool &&) = delete;
 
-    /* set a new size, and this will clear the task queue
-     * this will wait for all the running threads finish their current tasks, then stop them
-     * and create new threads */
+    /* the maximal size of a thread pool */
+    static constexpr size_type MAX_SIZE = 1024;
+
+    /* set a new size, the threads and the tasks in the queues are kept
+     * when the thread pool grows, the retired threads are reused if they have stopped,
+     * and the new threads are created for the rest
+     * when the thread pool shrinks, the surplus threads retire after their current tasks,
+     * the tasks left in their queues will be stolen by the other threads
+     * this does not wait for the retired threads, they are joined when their slots are reused,
+     * or by clear()
+     * NOTE: resizing to 0 is the same as clear(), the tasks in the queues will be discarded
+     *       newSize must not be greater than MAX_SIZE */
     void resize(size_type newSize);
 
     /* the size of the thread pool */
-    inline size_type size() { return threadQueue.size(); }
+    inline size_type size() const { return activeNum.load(std::memory_order_relaxed); }
 
     /* add a task to the thread pool
      * this will return a std::future
@@ -49,6 +79,37 @@ public:
     auto addTask(Function &&func, Args &&...args)
         -> std::future<std::invoke_result_t<Function, Args...>>;
 
+    /* add a task to the thread pool count times, the thread pool does not own the task
+     * run() or discard() of the task will be called count times in total
+     * the task must be alive until the last call returns
+     * NOTE: you can not add a task to a thread pool whose size is 0 */
+    void addTask(Task *task, const size_type &count = 1);
+
+    /* call function(i) for every i in [0, taskNum) with the threads of the pool
+     * the calling thread takes part in the calculation, and this returns when all calls finish,
+     * without waiting for the helpers which have not started, see ForkJoinTask
+     * the indices are claimed through an atomic counter, and the control blocks are reused,
+     * so this only allocates memory when all of them are in use
+     * if any call throws, the first exception will be rethrown in the calling thread */
+    template <class Function>
+    void parallelFor(const size_type &taskNum, Function &&function);
+
+    /* the reduction variant of parallelFor()
+     * return combine(...combine(combine(init, function(i)), function(j))..., function(k))
+     * where i, j, ..., k are all the indices in [0, taskNum) in an unspecified order
+     * NOTE: combine must be commutative and associative */
+    template <class ReturnType, class Function, class Combine>
+    ReturnType parallelReduce(const size_type &taskNum,
+                              ReturnType init,
+                              Function &&function,
+                              Combine &&combine);
+
+    /* run one queued task with the calling thread, return false if no task is run
+     * only the threads of the pool run tasks here, other threads always get false
+     * a thread of the pool calls this while waiting for other tasks,
+     * so that the waiting thread does not hold up the tasks queued behind it */
+    bool runPendingTask();
+
     /* stop all threads and clear the task queue
      * if a thread is running
      * this will wait for the thread to finish */
@@ -58,12 +119,120 @@ public:
     inline ~ThreadPool() { clear(); }
 
 private:
-    inline ThreadPool() = default;
-    /* private constructor, use getInstance() to get the instance */
-    std::vector<std::queue<std::function<void()>>> taskQueue;
-    std::queue<std::thread> threadQueue;
-    size_type i{0};
+    /* a task which owns a std::packaged_task, and destroys itself after running */
+    template <class ReturnType>
+    class PackagedTask : public Task {
+    public:
+        template <class Function>
+        explicit inline PackagedTask(Function &&func) : task(std::forward<Function>(func)) {}
+
+        inline void run() override {
+            task();
+            delete this;
+        }
+
+        inline void discard() override { delete this; }
+
+        inline std::future<ReturnType> getFuture() { return task.get_future(); }
+
+    private:
+        std::packaged_task<ReturnType()> task;
+    };
+
+    /* the control block of parallelFor(), which is owned by the pool and reused
+     * it is added once for every helper thread, every helper claims indices until
+     * all of them are claimed, and the calling thread waits until every claimed index finishes,
+     * so the helpers which start later claim nothing, and never call the function
+     * the block is returned to the pool when the caller and every helper have released it,
+     * so a late helper never sees the block of another call */
+    class ForkJoinTask : public Task {
+    public:
+        using Invoker = void (*)(const void *function, const size_type &k);
+
+        explicit inline ForkJoinTask(ThreadPool &pool) : pool(pool) {}
+
+        /* prepare the block for a call, which is released by the caller and helperNum helpers */
+        void start(const size_type &taskNum,
+                   const void *function,
+                   Invoker invoker,
+                   const size_type &helperNum);
+
+        inline void run() override {
+            execute();
+            release();
+        }
+
+        inline void discard() override { release(); }
+
+        /* claim the indices and call function until all the indices are claimed */
+        void execute();
+
+        /* wait until all the indices finish, release the block, and rethrow the first exception
+         * every claimed index is being run by a thread, so the caller only blocks */
+        void join();
+
+    private:
+        void release();
+
+        ThreadPool &pool;
+        size_type taskNum    = 0;
+        const void *function = nullptr;
+        Invoker invoker      = nullptr;
+        std::atomic<size_type> next{0};
+        std::atomic<size_type> finished{0};
+        std::atomic<size_type> references{0};
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    /* get a free control block of parallelFor(), a new one is created if there is none */
+    ForkJoinTask *acquireForkJoinTask();
+
+    /* every thread owns a task queue, the tasks are pushed round-robin
+     * a thread runs the tasks in its own queue first,
+     * when its queue is empty, it steals tasks from the others'
+     * the queues are the shards of the submission, the pushes into the same queue
+     * are serialized by pushMutex
+     * a worker is never destroyed before clear(), for other threads may still read it
+     * after it retires, its queue is still scanned by the thieves */
+    struct Worker {
+        std::mutex pushMutex;
+        WorkStealingQueue<Task *> tasks;
+        std::thread thread;
+        std::atomic<bool> retired{false};
+    };
+
+    /* the main loop of the id-th thread */
+    void work(const size_type &id);
+
+    /* find a task for the id-th thread, return nullptr when there is no task */
+    Task *findTask(const size_type &id);
+
+    /* check if there is any task in the queues */
+    bool hasTask() const;
+
+    /* the workers live in a fixed table, so that the readers need no lock when it grows
+     * slots[0, slotNum) are published, slots[0, activeNum) are not retired,
+     * and the workers are owned by workers */
+    std::unique_ptr<std::atomic<Worker *>[]> slots =
+        std::make_unique<std::atomic<Worker *>[]>(MAX_SIZE);
+    std::atomic<size_type> slotNum{0};
+    std::atomic<size_type> activeNum{0};
+    std::vector<std::unique_ptr<Worker>> workers;
+    /* serialize resize() and clear() */
+    std::mutex resizeMutex;
+    std::atomic<size_type> i{0};
     std::atomic<bool> stopped{false};
+    /* the idle threads sleep on sleepCondition */
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<size_type> sleeping{0};
+    /* the control blocks of parallelFor(), which live until the pool is destroyed,
+     * freeForkJoinTasks has the capacity for all of them, so releasing one never allocates */
+    std::mutex forkJoinMutex;
+    std::vector<std::unique_ptr<ForkJoinTask>> forkJoinTasks;
+    std::vector<ForkJoinTask *> freeForkJoinTasks;
 };
 
 template <class Function, class... Args>
@@ -71,11 +240,42 @@ auto ThreadPool::addTask(Function &&func, Args &&...args)
     -> std::future<std::invoke_result_t<Function, Args...>> {
     assert(size() != 0);
     using ReturnType = std::invoke_result_t<Function, Args...>;
-    auto taskPtr     = std::make_shared<std::packaged_task<ReturnType()>>(
+    auto task        = std::make_unique<PackagedTask<ReturnType>>(
         std::bind(std::forward<Function>(func), std::forward<Args>(args)...));
-    taskQueue[i].emplace([taskPtr]() { (*taskPtr)(); });
-    i = (i + 1) % size();
-    return taskPtr->get_future();
+    auto future = task->getFuture();
+    addTask(task.release());
+    return future;
+}
+
+template <class Function>
+void ThreadPool::parallelFor(const size_type &taskNum, Function &&function) {
+    if (taskNum == 0) { return; }
+    using Type = std::remove_reference_t<Function>;
+    // the calling thread is also a helper
+    const size_type helperNum = std::min(taskNum - 1, size());
+    ForkJoinTask *task        = acquireForkJoinTask();
+    task->start(
+        taskNum,
+        std::addressof(function),
+        [](const void *f, const size_type &k) { (*static_cast<Type *>(const_cast<void *>(f)))(k); },
+        helperNum);
+    if (helperNum > 0) { addTask(task, helperNum); }
+    task->execute();
+    task->join();
+}
+
+template <class ReturnType, class Function, class Combine>
+ReturnType ThreadPool::parallelReduce(const size_type &taskNum,
+                                      ReturnType init,
+                                      Function &&function,
+                                      Combine &&combine) {
+    std::mutex mutex;
+    parallelFor(taskNum, [&](const size_type &k) {
+        ReturnType value = function(k);
+        std::lock_guard<std::mutex> lock(mutex);
+        init = combine(std::move(init), std::move(value));
+    });
+    return init;
 }
 }  // namespace mca
 
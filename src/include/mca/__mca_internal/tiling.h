@@ -0,0 +1,95 @@
+#ifndef MCA_TILING_H
+#define MCA_TILING_H
+
+#include <algorithm>
+#include <cstddef>
+
+namespace mca {
+/* The partition of a rows x columns matrix into 2D tiles
+ * a tile is rowBlock x columnBlock, except the last ones of the rows and the columns,
+ * and the tiles are numbered row by row, so that the consecutive tiles share the rows */
+struct Tiling {
+    std::size_t rows        = 0;
+    std::size_t columns     = 0;
+    std::size_t rowBlock    = 0;
+    std::size_t columnBlock = 0;
+    std::size_t rowTiles    = 0;
+    std::size_t columnTiles = 0;
+
+    inline std::size_t tileNum() const { return rowTiles * columnTiles; }
+
+    /* get the rectangle [rowBegin:rowEnd, columnBegin:columnEnd] of the t-th tile */
+    inline void tile(const std::size_t &t,
+                     std::size_t &rowBegin,
+                     std::size_t &rowEnd,
+                     std::size_t &columnBegin,
+                     std::size_t &columnEnd) const {
+        rowBegin    = t / columnTiles * rowBlock;
+        rowEnd      = std::min(rows, rowBegin + rowBlock);
+        columnBegin = t % columnTiles * columnBlock;
+        columnEnd   = std::min(columns, columnBegin + columnBlock);
+    }
+};
+
+/* Partition a rows x columns matrix into at least taskNum tiles
+ * the tiles start as rowBlock x columnBlock, then the longer side is halved until there are
+ * enough tiles for the tasks, the sides are kept as the multiples of rowUnit and columnUnit,
+ * and a tile is never smaller than rowUnit x columnUnit
+ * NOTE: there may be fewer tiles than taskNum when the matrix is too small */
+inline Tiling partitionTiles(const std::size_t &rows,
+                             const std::size_t &columns,
+                             const std::size_t &rowBlock,
+                             const std::size_t &columnBlock,
+                             const std::size_t &rowUnit,
+                             const std::size_t &columnUnit,
+                             const std::size_t &taskNum) {
+    Tiling tiling;
+    if (rows == 0 || columns == 0) { return tiling; }
+    auto count = [](const std::size_t &n, const std::size_t &block) {
+        return (n + block - 1) / block;
+    };
+    auto half = [&count](const std::size_t &block, const std::size_t &unit) {
+        return std::max(unit, count(block / 2, unit) * unit);
+    };
+    tiling.rows        = rows;
+    tiling.columns     = columns;
+    tiling.rowBlock    = std::min(rowBlock, rows);
+    tiling.columnBlock = std::min(columnBlock, columns);
+    while (count(rows, tiling.rowBlock) * count(columns, tiling.columnBlock) < taskNum) {
+        const bool rowSplittable    = tiling.rowBlock > rowUnit;
+        const bool columnSplittable = tiling.columnBlock > columnUnit;
+        if (rowSplittable && (!columnSplittable || tiling.rowBlock >= tiling.columnBlock)) {
+            tiling.rowBlock = half(tiling.rowBlock, rowUnit);
+        } else if (columnSplittable) {
+            tiling.columnBlock = half(tiling.columnBlock, columnUnit);
+        } else {
+            break;
+        }
+    }
+    tiling.rowTiles    = count(rows, tiling.rowBlock);
+    tiling.columnTiles = count(columns, tiling.columnBlock);
+    return tiling;
+}
+
+/* The pairs of the blocks (i, j) where i <= j in a n x n grid of blocks, numbered row by row
+ * a pair is a block of the upper triangle with the diagonal, and its mirror across the diagonal */
+struct TrianglePairs {
+    std::size_t n = 0;
+
+    inline std::size_t pairNum() const { return n * (n + 1) / 2; }
+
+    /* get the t-th pair */
+    inline void pair(const std::size_t &t, std::size_t &i, std::size_t &j) const {
+        std::size_t rest = t;
+        for (i = 0; rest >= n - i; i++) { rest -= n - i; }
+        j = i + rest;
+    }
+
+    /* move (i, j) to the next pair */
+    inline void next(std::size_t &i, std::size_t &j) const {
+        if (++j == n) { j = ++i; }
+    }
+};
+}  // namespace mca
+
+#endif
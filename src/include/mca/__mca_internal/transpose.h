@@ -0,0 +1,253 @@
+#ifndef MCA_TRANSPOSE_H
+#define MCA_TRANSPOSE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix_declaration.h"
+#include "mca/shape.h"
+#include "tiling.h"
+
+namespace mca {
+/* The block sizes of the transposition of the matrices whose elements are T
+ * a BLOCK x BLOCK block of the source and its transposed block of the target stay in L1,
+ * so that neither of them is read or written with a whole row of stride out of the cache,
+ * and a block is transposed by TILE x TILE tiles, which are shuffled in the registers */
+template <class T>
+struct TransposeBlocking {
+    static constexpr std::size_t TILE  = 8;
+    static constexpr std::size_t BLOCK = std::clamp<std::size_t>(256 / sizeof(T), 2 * TILE, 64) /
+                                         TILE * TILE;
+};
+
+/* A SIMD kernel transposes a TILE x TILE tile of source into target
+ * the strides are the numbers of the elements between two rows of source and target */
+using TransposeKernel = void (*)(const void *source,
+                                 const std::size_t &sourceStride,
+                                 void *target,
+                                 const std::size_t &targetStride);
+
+/* Get the SIMD kernel which transposes the tiles whose elements are elementSize bytes,
+ * the kernel only moves the bits, so it serves every trivially copyable type of the size
+ * the newest one of AVX-512, AVX2 and SSE2 for the running CPU is used
+ * return nullptr if there is none, then the elements are transposed one by one */
+TransposeKernel transposeSimdKernel(const std::size_t &elementSize);
+
+/* Transpose a[rowBegin:rowEnd, columnBegin:columnEnd] into
+ * output[columnBegin:columnEnd, rowBegin:rowEnd] element by element */
+template <class T, class O>
+void transposeElements(const Matrix<T> &a,
+                       Matrix<O> &output,
+                       const std::size_t &rowBegin,
+                       const std::size_t &rowEnd,
+                       const std::size_t &columnBegin,
+                       const std::size_t &columnEnd) {
+    for (std::size_t i = rowBegin; i < rowEnd; i++) {
+        for (std::size_t j = columnBegin; j < columnEnd; j++) {
+            output.get(j, i) = static_cast<O>(a.get(i, j));
+        }
+    }
+}
+
+/* Transpose a[rowBegin:rowEnd, columnBegin:columnEnd] into
+ * output[columnBegin:columnEnd, rowBegin:rowEnd] block by block, see TransposeBlocking
+ * the full tiles are transposed by the SIMD kernel if T and O are the same and there is one,
+ * and the rest are transposed element by element
+ * NOTE: output must be a.columns() x a.rows(), and it must not be a */
+template <class T, class O>
+void transposeBlocked(const Matrix<T> &a,
+                      Matrix<O> &output,
+                      const std::size_t &rowBegin,
+                      const std::size_t &rowEnd,
+                      const std::size_t &columnBegin,
+                      const std::size_t &columnEnd) {
+    constexpr std::size_t TILE  = TransposeBlocking<T>::TILE;
+    constexpr std::size_t BLOCK = TransposeBlocking<T>::BLOCK;
+    TransposeKernel kernel      = nullptr;
+    if constexpr (std::is_same_v<T, O> && std::is_trivially_copyable_v<T>) {
+        kernel = transposeSimdKernel(sizeof(T));
+    }
+    const std::size_t sourceStride = a.columns(), targetStride = output.columns();
+    for (std::size_t ib = rowBegin; ib < rowEnd; ib += BLOCK) {
+        const std::size_t ie = std::min(rowEnd, ib + BLOCK);
+        for (std::size_t jb = columnBegin; jb < columnEnd; jb += BLOCK) {
+            const std::size_t je = std::min(columnEnd, jb + BLOCK);
+            std::size_t i        = ib;
+            if (kernel != nullptr) {
+                for (; i + TILE <= ie; i += TILE) {
+                    std::size_t j = jb;
+                    for (; j + TILE <= je; j += TILE) {
+                        kernel(a.data() + i * sourceStride + j,
+                               sourceStride,
+                               output.data() + j * targetStride + i,
+                               targetStride);
+                    }
+                    transposeElements(a, output, i, i + TILE, j, je);
+                }
+            }
+            transposeElements(a, output, i, ie, jb, je);
+        }
+    }
+}
+
+/* Partition a rows x columns matrix of T into at least taskNum tiles to transpose
+ * the tiles start as the whole matrix, and they are split into the blocks of transposeBlocked(),
+ * see partitionTiles() */
+template <class T>
+Tiling transposeTiling(const std::size_t &rows,
+                       const std::size_t &columns,
+                       const std::size_t &taskNum) {
+    constexpr std::size_t BLOCK = TransposeBlocking<T>::BLOCK;
+    return partitionTiles(rows, columns, rows, columns, BLOCK, BLOCK, taskNum);
+}
+
+/* Swap a[i, j] and a[j, i] for every position (i, j) in a[rowBegin:rowEnd, columnBegin:columnEnd]
+ * where i < j, so that the rectangle may cross the diagonal
+ * NOTE: a must be a square matrix */
+template <class T>
+void swapTransposedElements(Matrix<T> &a,
+                            const std::size_t &rowBegin,
+                            const std::size_t &rowEnd,
+                            const std::size_t &columnBegin,
+                            const std::size_t &columnEnd) {
+    using std::swap;
+    for (std::size_t i = rowBegin; i < rowEnd; i++) {
+        for (std::size_t j = std::max(columnBegin, i + 1); j < columnEnd; j++) {
+            swap(a.get(i, j), a.get(j, i));
+        }
+    }
+}
+
+/* Swap the TILE x TILE tile of a at (i, j) with the transposition of the tile at (j, i)
+ * with kernel, the tile at (i, j) is kept in a buffer meanwhile, and i may be equal to j
+ * NOTE: a must be a square matrix */
+template <class T>
+void swapTransposedTiles(const TransposeKernel &kernel,
+                         Matrix<T> &a,
+                         const std::size_t &i,
+                         const std::size_t &j) {
+    constexpr std::size_t TILE = TransposeBlocking<T>::TILE;
+    const std::size_t n        = a.columns();
+    T buffer[TILE * TILE];
+    kernel(a.data() + i * n + j, n, buffer, TILE);
+    if (i != j) { kernel(a.data() + j * n + i, n, a.data() + i * n + j, n); }
+    for (std::size_t k = 0; k < TILE; k++) {
+        std::memcpy(a.data() + (j + k) * n + i, buffer + k * TILE, TILE * sizeof(T));
+    }
+}
+
+/* The pairs of the blocks of a n x n matrix of T, which are the blocks of transposeBlocked() */
+template <class T>
+TrianglePairs transposeBlockPairs(const std::size_t &n) {
+    constexpr std::size_t BLOCK = TransposeBlocking<T>::BLOCK;
+    return TrianglePairs{(n + BLOCK - 1) / BLOCK};
+}
+
+/* Transpose the pair of the blocks of a square matrix at (rowBlock, columnBlock) and
+ * (columnBlock, rowBlock) in place, see TransposeBlocking and TrianglePairs
+ * the blocks are swapped by the pairs of the tiles, the full ones with the SIMD kernel
+ * if there is one, and the rest element by element
+ * NOTE: a must be a square matrix, and rowBlock <= columnBlock */
+template <class T>
+void transposeBlockPair(Matrix<T> &a, const std::size_t &rowBlock, const std::size_t &columnBlock) {
+    constexpr std::size_t TILE  = TransposeBlocking<T>::TILE;
+    constexpr std::size_t BLOCK = TransposeBlocking<T>::BLOCK;
+    TransposeKernel kernel      = nullptr;
+    if constexpr (std::is_trivially_copyable_v<T>) { kernel = transposeSimdKernel(sizeof(T)); }
+    const std::size_t n           = a.rows();
+    const std::size_t rowBegin    = rowBlock * BLOCK, rowEnd = std::min(n, rowBegin + BLOCK);
+    const std::size_t columnBegin = columnBlock * BLOCK;
+    const std::size_t columnEnd   = std::min(n, columnBegin + BLOCK);
+    for (std::size_t i = rowBegin; i < rowEnd; i += TILE) {
+        // the tiles below the diagonal are the mirrors of the ones above it
+        for (std::size_t j = rowBlock == columnBlock ? i : columnBegin; j < columnEnd; j += TILE) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (kernel != nullptr && i + TILE <= rowEnd && j + TILE <= columnEnd) {
+                    swapTransposedTiles(kernel, a, i, j);
+                    continue;
+                }
+            }
+            swapTransposedElements(a,
+                                   i,
+                                   std::min(rowEnd, i + TILE),
+                                   j,
+                                   std::min(columnEnd, j + TILE));
+        }
+    }
+}
+
+/* Check if predicate(a[i, j], a[j, i]) is true for every position (i, j) where i < j
+ * in the pairs of the blocks [pos, pos + len) of transposeBlockPairs<T>(a.rows()),
+ * so that every element of the strict upper triangle is read once with its mirror,
+ * and both of them are read from the blocks in L1
+ * stop is checked before every pair
+ * return false when any predicate(a[i, j], a[j, i]) is false or when *stop is true
+ * NOTE: a must be a square matrix */
+template <class T, class Predicate>
+bool allOfMirroredElements(const Matrix<T> &a,
+                           const std::size_t &pos,
+                           const std::size_t &len,
+                           const std::atomic<bool> *stop,
+                           Predicate &&predicate) {
+    constexpr std::size_t BLOCK = TransposeBlocking<T>::BLOCK;
+    const std::size_t n         = a.rows();
+    const TrianglePairs pairs   = transposeBlockPairs<T>(n);
+    if (len == 0) { return true; }
+    std::size_t rowBlock = 0, columnBlock = 0;
+    pairs.pair(pos, rowBlock, columnBlock);
+    for (std::size_t t = 0; t < len; t++, pairs.next(rowBlock, columnBlock)) {
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) { return false; }
+        const std::size_t rowBegin    = rowBlock * BLOCK, rowEnd = std::min(n, rowBegin + BLOCK);
+        const std::size_t columnBegin = columnBlock * BLOCK;
+        const std::size_t columnEnd   = std::min(n, columnBegin + BLOCK);
+        for (std::size_t i = rowBegin; i < rowEnd; i++) {
+            for (std::size_t j = std::max(columnBegin, i + 1); j < columnEnd; j++) {
+                if (!predicate(a.get(i, j), a.get(j, i))) { return false; }
+            }
+        }
+    }
+    return true;
+}
+
+/* Transpose a rectangular matrix in place by following the cycles of the permutation
+ * the element at p of the result comes from the position of its transposition in a,
+ * so every cycle is walked from its first position, which is the smallest one,
+ * and a bitmap of a.size() bits records the moved positions
+ * NOTE: the cycles are walked in the calling thread */
+template <class T>
+void transposeCycles(Matrix<T> &a) {
+    const std::size_t rows = a.rows(), columns = a.columns(), size = a.size();
+    const Shape shape{columns, rows};
+    // a row or a column has the same elements in the same order after transposition
+    if (rows <= 1 || columns <= 1) {
+        a.reshape(shape);
+        return;
+    }
+    // the position in a whose element is at p after transposition
+    auto source = [&rows, &columns](const std::size_t &p) {
+        return p % rows * columns + p / rows;
+    };
+    std::vector<bool> moved(size, false);
+    T *data = a.data();
+    // the first and the last elements never move
+    for (std::size_t start = 1; start + 1 < size; start++) {
+        if (moved[start]) { continue; }
+        T value       = std::move(data[start]);
+        std::size_t p = start;
+        for (std::size_t next = source(p); next != start; p = next, next = source(p)) {
+            data[p]  = std::move(data[next]);
+            moved[p] = true;
+        }
+        data[p]  = std::move(value);
+        moved[p] = true;
+    }
+    a.reshape(shape);
+}
+}  // namespace mca
+
+#endif
@@ -1,13 +1,17 @@
 #ifndef MCA_UTILITY_H
 #define MCA_UTILITY_H
 
-#include <future>
+#include <algorithm>
+#include <atomic>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "calculation_task_num.h"
 #include "matrix_declaration.h"
+#include "operation.h"
+#include "tiling.h"
+#include "mca/execution_context.h"
 #include "mca/mca_config.h"
 
 namespace mca {
@@ -21,50 +25,63 @@ using size_type = std::size_t;
 template <class T>
 inline constexpr bool is_matrix_v = is_matrix<T>::value;
 
-/* Return calculation for every thread and the number of tasks */
-inline CalculationTaskNum threadCalculationTaskNum(const size_type &total) {
-    size_type calculation = std::max(total / (threadNum() + 1), limit());
-    size_type taskNum     = total / calculation;
-    if (total % calculation > 0) { taskNum++; }
-    return CalculationTaskNum{calculation, taskNum};
-}
-
-enum class Operation : unsigned short {
-    MATRIX_ADDITION,
-    MATRIX_SUBTRACTION,
-    MATRIX_MULTIPLICATION,
-
-    NUMBER_MATRIX_ADDITION,
-    NUMBER_MATRIX_SUBTRACTION,
-    NUMBER_MATRIX_MULTIPLICATION,
-    NUMBER_MATRIX_DIVISION,
-    NUMBER_MATRIX_POW,
+// Check if the result of T and U is T, so that it can be stored in the elements of a matrix of T
+template <class T, class U, class = void>
+struct is_reusable : std::false_type {};
+template <class T, class U>
+struct is_reusable<T, U, std::void_t<std::common_type_t<T, U>>>
+    : std::is_same<std::common_type_t<T, U>, T> {};
+template <class T, class U>
+inline constexpr bool is_reusable_v = is_reusable<T, U>::value;
 
-    MATRIX_NUMBER_ADDITION,
-    MATRIX_NUMBER_SUBTRACTION,
-    MATRIX_NUMBER_MULTIPLICATION,
-    MATRIX_NUMBER_DIVISION,
-    MATRIX_NUMBER_POW,
+/* The number of elements checked between two checks of the cancellation flag */
+inline constexpr size_type CANCELLATION_BLOCK_SIZE = 4096;
 
-    MATRIX_EQUALITY,
-    MATRIX_INEQUALITY,
-    MATRIX_LESS,
-    MATRIX_LESS_EQUAL,
-    MATRIX_GREATER,
-    MATRIX_GREATER_EQUAL,
+/* Check if predicate(begin, end) is true for every block [begin, end) of [pos, pos + len)
+ * the blocks are CANCELLATION_BLOCK_SIZE elements, except the last one,
+ * and stop is checked before every block
+ * return false when any predicate(begin, end) is false or when *stop is true */
+template <class Predicate>
+inline bool allOfBlocksSingleThread(const size_type &pos,
+                                    const size_type &len,
+                                    const std::atomic<bool> *stop,
+                                    Predicate &&predicate) {
+    for (size_type start = pos; start < pos + len; start += CANCELLATION_BLOCK_SIZE) {
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) { return false; }
+        size_type end = std::min(pos + len, start + CANCELLATION_BLOCK_SIZE);
+        if (!predicate(start, end)) { return false; }
+    }
+    return true;
+}
 
-    MATRIX_SYMMETRIC,
-    MATRIX_ANTISYMMETRIC,
+/* Check if predicate(i) is true for every i in [pos, pos + len)
+ * the elements are checked block by block, and stop is checked before every block
+ * return false when any predicate(i) is false or when *stop is true */
+template <class Predicate>
+inline bool allOfSingleThread(const size_type &pos,
+                              const size_type &len,
+                              const std::atomic<bool> *stop,
+                              Predicate &&predicate) {
+    return allOfBlocksSingleThread(pos,
+                                   len,
+                                   stop,
+                                   [&predicate](const size_type &begin, const size_type &end) {
+                                       for (size_type i = begin; i < end; i++) {
+                                           if (!predicate(i)) { return false; }
+                                       }
+                                       return true;
+                                   });
+}
 
-    MATRIX_TRANSPOSE,
-    MATRIX_FILL,
-    MATRIX_COPY_ASSIGNMENT,
-    MATRIX_CONSTRUCT_DIAG,
-    MATRIX_CONSTRUCT_FROM_POINTER,
-    MATRIX_CONSTRUCT_FROM_VECTOR,
-    MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST,
-    MATRIX_CONSTRUCT_IDENTITY,
-};
+/* Return calculation for every thread and the number of tasks
+ * every task calculates at least grain(op, sizeof(T)) elements, T is the type of the elements */
+template <class T>
+inline CalculationTaskNum threadCalculationTaskNum(const Operation &op, const size_type &total) {
+    size_type calculation = std::max(total / (threadNum() + 1), grain(op, sizeof(T)));
+    size_type taskNum     = total / calculation;
+    if (total % calculation > 0) { taskNum++; }
+    return CalculationTaskNum{calculation, taskNum};
+}
 
 template <class ReturnType, class Function>
 void calculationHelper(const Operation &op,
@@ -83,33 +100,71 @@ void calculationHelper(const Operation &op,
         }
         return;
     }
-    std::vector<std::future<std::invoke_result_t<Function, const size_t &, const size_t &>>>
-        subThreadReturnValue(calculationTaskNum.taskNum - 1);
-    for (size_type i = 0; i < subThreadReturnValue.size(); i++) {
-        subThreadReturnValue[i] =
-            threadPool().addTask([start = i * calculationTaskNum.calculation,
-                                  len   = calculationTaskNum.calculation,
-                                  &function]() { return function(start, len); });
-    }
+    // the tasks run in the context of the calling thread, whichever thread runs them
+    ExecutionContext &context = currentContext();
+    // the last task calculates the rest part
+    auto task = [&context, &endPos, &calculationTaskNum, &function](const size_type &i,
+                                                                    auto &&...stop) {
+        ScopedExecutionContext scope(context);
+        size_type start = i * calculationTaskNum.calculation;
+        size_type len   = calculationTaskNum.calculation;
+        if (i + 1 == calculationTaskNum.taskNum) { len = endPos - start; }
+        return function(start, len, stop...);
+    };
     if constexpr (std::is_same_v<ReturnType, std::nullptr_t>) {
-        function((calculationTaskNum.taskNum - 1) * calculationTaskNum.calculation,
-                 endPos - (calculationTaskNum.taskNum - 1) * calculationTaskNum.calculation);
+        context.threadPool().parallelFor(calculationTaskNum.taskNum, task);
     } else {
-        returnValue =
-            function((calculationTaskNum.taskNum - 1) * calculationTaskNum.calculation,
-                     endPos - (calculationTaskNum.taskNum - 1) * calculationTaskNum.calculation);
+        // once a task gets the decisive result, the other tasks are cancelled:
+        // the tasks which have not started will be skipped,
+        // and the running tasks will stop at their next checks of stop
+        bool decisive = op == Operation::MATRIX_INEQUALITY;
+        std::atomic<bool> stop{false};
+        returnValue = context.threadPool().parallelReduce(
+            calculationTaskNum.taskNum,
+            !decisive,
+            [&task, &stop, decisive](const size_type &i) {
+                if (stop.load(std::memory_order_relaxed)) { return !decisive; }
+                bool result = task(i, &stop);
+                if (result == decisive) { stop.store(true, std::memory_order_relaxed); }
+                return result;
+            },
+            [decisive](bool a, bool b) { return decisive ? a || b : a && b; });
     }
-    for (auto &item : subThreadReturnValue) {
-        if constexpr (std::is_same_v<ReturnType, std::nullptr_t>) {
-            item.get();
-        } else {
-            if (op == Operation::MATRIX_INEQUALITY) {
-                returnValue |= item.get();
-            } else {
-                returnValue &= item.get();
-            }
-        }
+}
+
+/* Turn calculationTaskNum, the partition of the elements, into the partition of tileNum tiles
+ * whose taskNum is at most tileNum, and every task calculates the same number of tiles but the
+ * last one */
+inline CalculationTaskNum tileCalculationTaskNum(CalculationTaskNum calculationTaskNum,
+                                                 const size_type &tileNum) {
+    calculationTaskNum.taskNum = std::min(calculationTaskNum.taskNum, tileNum);
+    if (calculationTaskNum.taskNum > 0) {
+        calculationTaskNum.calculation =
+            (tileNum + calculationTaskNum.taskNum - 1) / calculationTaskNum.taskNum;
+        calculationTaskNum.taskNum =
+            (tileNum + calculationTaskNum.calculation - 1) / calculationTaskNum.calculation;
     }
+    return calculationTaskNum;
+}
+
+/* Call function(rowBegin, rowEnd, columnBegin, columnEnd) for every tile of tiling
+ * every task calculates consecutive tiles by calculationHelper(), see tileCalculationTaskNum() */
+template <class Function>
+void tileCalculationHelper(const Operation &op,
+                           const Tiling &tiling,
+                           const CalculationTaskNum &calculationTaskNum,
+                           Function &&function) {
+    calculationHelper(op,
+                      tiling.tileNum(),
+                      tileCalculationTaskNum(calculationTaskNum, tiling.tileNum()),
+                      nullptr,
+                      [&tiling, &function](const size_type &start, const size_type &len) {
+                          size_type rowBegin = 0, rowEnd = 0, columnBegin = 0, columnEnd = 0;
+                          for (size_type t = start; t < start + len; t++) {
+                              tiling.tile(t, rowBegin, rowEnd, columnBegin, columnEnd);
+                              function(rowBegin, rowEnd, columnBegin, columnEnd);
+                          }
+                      });
 }
 }  // namespace mca
 #endif
@@ -0,0 +1,132 @@
+#ifndef MCA_WORK_STEALING_QUEUE_H
+#define MCA_WORK_STEALING_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mca {
+/* A Chase-Lev work-stealing deque
+ * The owner pushes and pops at the bottom, other threads steal from the top
+ * push() and pop() can only be called by the owner (or with synchronizations among the callers),
+ * steal() and empty() can be called by any thread at any time
+ * T must be trivially copyable, usually T is a pointer
+ * See "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013) */
+template <class T>
+class WorkStealingQueue {
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    /* capacity will be rounded up to a power of 2 */
+    explicit inline WorkStealingQueue(size_type capacity = 64) {
+        size_type actualCapacity = 1;
+        while (actualCapacity < capacity) { actualCapacity <<= 1; }
+        buffers.emplace_back(std::make_unique<Buffer>(actualCapacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingQueue(const WorkStealingQueue &)            = delete;
+    WorkStealingQueue(WorkStealingQueue &&)                 = delete;
+    WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+    WorkStealingQueue &operator=(WorkStealingQueue &&)      = delete;
+
+    /* push an item at the bottom, the buffer will grow when it is full */
+    inline void push(const value_type &item) {
+        difference_type b = bottom.load(std::memory_order_relaxed);
+        difference_type t = top.load(std::memory_order_acquire);
+        Buffer *current   = buffer.load(std::memory_order_relaxed);
+        if (b - t > current->capacity() - 1) {
+            // the old buffers are kept alive, for thieves may still read them
+            buffers.emplace_back(current->grow(b, t));
+            current = buffers.back().get();
+            buffer.store(current, std::memory_order_release);
+        }
+        current->put(b, item);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /* pop an item from the bottom, return false when the queue is empty */
+    inline bool pop(value_type &item) {
+        difference_type b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *current   = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        difference_type t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = current->get(b);
+        if (t == b) {
+            // the last item, race with the thieves
+            bool won = top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /* steal an item from the top
+     * return false when the queue is empty or another thread took the item first */
+    inline bool steal(value_type &item) {
+        difference_type t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        difference_type b = bottom.load(std::memory_order_acquire);
+        if (t >= b) { return false; }
+        item = buffer.load(std::memory_order_acquire)->get(t);
+        return top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /* check if the queue is empty, the result may be outdated when it returns */
+    inline bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    /* a circular array whose capacity is a power of 2 */
+    class Buffer {
+    public:
+        explicit inline Buffer(size_type capacity)
+            : mask(static_cast<difference_type>(capacity) - 1),
+              items(std::make_unique<std::atomic<value_type>[]>(capacity)) {}
+
+        inline difference_type capacity() const { return mask + 1; }
+
+        inline value_type get(const difference_type &i) const {
+            return items[i & mask].load(std::memory_order_relaxed);
+        }
+
+        inline void put(const difference_type &i, const value_type &item) {
+            items[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        inline std::unique_ptr<Buffer> grow(const difference_type &b,
+                                            const difference_type &t) const {
+            auto result = std::make_unique<Buffer>(static_cast<size_type>(capacity()) * 2);
+            for (difference_type i = t; i < b; i++) { result->put(i, get(i)); }
+            return result;
+        }
+
+    private:
+        difference_type mask;
+        std::unique_ptr<std::atomic<value_type>[]> items;
+    };
+
+    alignas(64) std::atomic<difference_type> top{0};
+    alignas(64) std::atomic<difference_type> bottom{0};
+    std::atomic<Buffer *> buffer{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+}  // namespace mca
+
+#endif
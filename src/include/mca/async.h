@@ -0,0 +1,171 @@
+#ifndef MCA_ASYNC_H
+#define MCA_ASYNC_H
+
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "__mca_internal/async_state.h"
+#include "__mca_internal/matrix_declaration.h"
+#include "execution_context.h"
+#include "matrix.h"
+#include "mca.h"
+
+/* The asynchronous calculations
+ * every function in this namespace starts the calculation in the threads of the current context,
+ * and returns a Future at once, so that independent calculations can share the thread pool
+ * NOTE: the matrices are not copied, they must be alive until the calculation finishes
+ *       when the context has no thread, the calculation finishes before the function returns */
+namespace mca {
+namespace async {
+/* the return type of function(result) in Future<T>::then() */
+template <class Function, class T>
+struct ContinuationResult {
+    using type = std::invoke_result_t<Function &, T>;
+};
+template <class Function>
+struct ContinuationResult<Function, void> {
+    using type = std::invoke_result_t<Function &>;
+};
+
+template <class T>
+class Future {
+public:
+    using value_type = T;
+
+    /* construct an invalid future */
+    inline Future() = default;
+
+    explicit inline Future(std::shared_ptr<AsyncState<T>> state) : state(std::move(state)) {}
+
+    /* check if the future refers to a calculation
+     * the future becomes invalid after get() or then() */
+    inline bool valid() const { return state != nullptr; }
+
+    /* check if the calculation has finished */
+    inline bool ready() const { return state->ready(); }
+
+    /* wait until the calculation finishes
+     * if the calling thread belongs to the thread pool, it runs the queued tasks while waiting */
+    inline void wait() const { state->wait(); }
+
+    /* wait, then return the result
+     * if the calculation throws, the exception will be rethrown here */
+    T get();
+
+    /* start function(result) when the calculation finishes, and return the future of it
+     * if the calculation throws, the exception will be passed to the returned future
+     * for example: async::multiply(a, b).then([&c](Matrix<int> &&product) { return product + c; })
+     * NOTE: when T is void, function takes no argument
+ *       function is moved into the future, so it may be move-only */
+    template <class Function>
+    auto then(Function &&function);
+
+private:
+    std::shared_ptr<AsyncState<T>> state;
+};
+
+/* Start function() in the threads of context, and return the future of its result */
+template <class Function>
+auto run(ExecutionContext &context, Function &&function) {
+    using ReturnType = std::invoke_result_t<std::decay_t<Function> &>;
+    auto state       = std::make_shared<AsyncState<ReturnType>>(context);
+    AsyncState<ReturnType>::launch(state, std::forward<Function>(function));
+    return Future<ReturnType>(std::move(state));
+}
+
+/* Start function() in the threads of the current context, and return the future of its result */
+template <class Function>
+auto run(Function &&function) {
+    return run(currentContext(), std::forward<Function>(function));
+}
+
+/* The matrices are captured by reference, and the numbers are copied,
+ * for the numbers are often temporary objects */
+template <class T>
+using Operand = std::conditional_t<is_matrix_v<T>, const T &, T>;
+
+/* Start function(a, b) in the threads of the current context */
+template <class A, class B, class Function>
+auto runBinary(const A &a, const B &b, Function function) {
+    return run([operands = std::tuple<Operand<A>, Operand<B>>(a, b), function]() {
+        return function(std::get<0>(operands), std::get<1>(operands));
+    });
+}
+
+/* Start a + b, where a and b are matrices or one of them is a number */
+template <class A, class B>
+auto add(const A &a, const B &b) -> Future<decltype(a + b)> {
+    return runBinary(a, b, std::plus<>());
+}
+
+/* Start a - b, where a and b are matrices or one of them is a number */
+template <class A, class B>
+auto subtract(const A &a, const B &b) -> Future<decltype(a - b)> {
+    return runBinary(a, b, std::minus<>());
+}
+
+/* Start a * b, where a and b are matrices or one of them is a number */
+template <class A, class B>
+auto multiply(const A &a, const B &b) -> Future<decltype(a * b)> {
+    return runBinary(a, b, std::multiplies<>());
+}
+
+/* Start a / b, where a is a matrix and b is a number, or a is a number and b is a matrix */
+template <class A, class B>
+auto divide(const A &a, const B &b) -> Future<decltype(a / b)> {
+    return runBinary(a, b, std::divides<>());
+}
+
+/* Start transposing a, the result is a new matrix */
+template <class T>
+Future<Matrix<T>> transpose(const Matrix<T> &a) {
+    return run([&a]() { return a.transpose(); });
+}
+
+/* Start calculating a to the exponent-th power, the result is a new matrix
+ * NOTE: a must be a square matrix */
+template <class T>
+Future<Matrix<T>> pow(const Matrix<T> &a, const size_type &exponent) {
+    return run([&a, exponent]() {
+        Matrix<T> output(a.shape());
+        mca::pow(a, exponent, output);
+        return output;
+    });
+}
+
+template <class T>
+T Future<T>::get() {
+    auto current = std::move(state);
+    if constexpr (std::is_void_v<T>) {
+        current->value();
+    } else {
+        return std::move(current->value());
+    }
+}
+
+template <class T>
+template <class Function>
+auto Future<T>::then(Function &&function) {
+    using ReturnType = typename ContinuationResult<std::decay_t<Function>, T>::type;
+    auto previous    = std::move(state);
+    auto next        = std::make_shared<AsyncState<ReturnType>>(previous->getContext());
+    previous->onReady([previous, next, function = std::forward<Function>(function)]() mutable {
+        AsyncState<ReturnType>::launch(
+            next, [previous, function = std::move(function)]() mutable -> ReturnType {
+                if constexpr (std::is_void_v<T>) {
+                    previous->value();
+                    return function();
+                } else {
+                    return function(std::move(previous->value()));
+                }
+            });
+    });
+    return Future<ReturnType>(std::move(next));
+}
+}  // namespace async
+}  // namespace mca
+
+#endif
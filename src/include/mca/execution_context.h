@@ -0,0 +1,151 @@
+#ifndef MCA_EXECUTION_CONTEXT_H
+#define MCA_EXECUTION_CONTEXT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "__mca_internal/operation.h"
+#include "__mca_internal/thread_pool.h"
+
+namespace mca {
+/* The number of the element size classes of the grain table
+ * the classes are 1, 2, 4, 8, and 16 or more bytes */
+inline constexpr std::size_t ELEMENT_SIZE_CLASS_NUM = 5;
+
+/* The default side of the square matrices from which the multiplication uses Strassen-Winograd */
+inline constexpr std::size_t DEFAULT_STRASSEN_CROSSOVER = 2048;
+
+/* An execution context owns the configurations of the calculations:
+ * a thread pool, a grain table, a limit, an epsilon and the Strassen-Winograd options
+ * every calculation uses the current context of the calling thread, see currentContext()
+ * the functions in mca_config.h read and write the current context
+ * NOTE: the setters are not thread-safe, do not call them when the context is calculating */
+class ExecutionContext {
+public:
+    using size_type = std::size_t;
+
+    /* create a context which owns a thread pool of threadNum threads */
+    explicit ExecutionContext(const size_type &threadNum = 0,
+                              const size_type &limit     = 623,
+                              const double &eps          = 1e-100);
+
+    /* create a context which uses the threads of pool
+     * NOTE: pool must be alive until the context is destroyed */
+    explicit ExecutionContext(ThreadPool &pool,
+                              const size_type &limit = 623,
+                              const double &eps      = 1e-100);
+
+    ExecutionContext(const ExecutionContext &)            = delete;
+    ExecutionContext(ExecutionContext &&)                 = delete;
+    ExecutionContext &operator=(const ExecutionContext &) = delete;
+    ExecutionContext &operator=(ExecutionContext &&)      = delete;
+
+    /* call function with this context as the current context of the calling thread,
+     * and return what function returns
+     * this is how to calculate with operators in the context, e.g.
+     * context.run([&]() { return a * b + c; }) */
+    template <class Function>
+    decltype(auto) run(Function &&function);
+
+    /* Set how many threads will be used when calculating */
+    void setThreadNum(const size_type &threadNum);
+
+    /* Set the minimal quantity of a thread's calculation, and clear the grain table
+     * see setLimit() in mca_config.h */
+    void setLimit(const size_type &limit);
+
+    /* Set the grain of op for the elements whose size is elementSize bytes
+     * see setGrain() in mca_config.h */
+    void setGrain(const Operation &op, const size_type &elementSize, const size_type &grain);
+
+    /* Fill the grain table by measuring every operation, see calibrate() in mca_config.h */
+    void calibrate();
+
+    /* Save the grain table to the file of path, return false if the file can not be written */
+    bool saveGrainTable(const std::string &path) const;
+
+    /* Load the grain table from the file of path written by saveGrainTable()
+     * return false and keep the current table if the file can not be read or is invalid */
+    bool loadGrainTable(const std::string &path);
+
+    /* Set the epsilon used for comparing floating numbers */
+    inline void setEpsilon(const double &eps) { _eps = eps; }
+
+    /* Set the crossover of Strassen-Winograd, see setStrassenCrossover() in mca_config.h */
+    inline void setStrassenCrossover(const size_type &crossover) {
+        _strassenCrossover = crossover == 0 ? 0 : std::max<size_type>(2, crossover);
+    }
+
+    /* Set whether the floating-point products may use Strassen-Winograd,
+     * see setStrassenFloatingPoint() in mca_config.h */
+    inline void setStrassenFloatingPoint(const bool &enabled) { _strassenFloatingPoint = enabled; }
+
+    /* Return the thread number of the context */
+    inline size_type threadNum() const { return _threadPool->size(); }
+
+    /* Return the limit of the context */
+    inline size_type limit() const { return _limit; }
+
+    /* Return the grain of op for the elements whose size is elementSize bytes
+     * see grain() in mca_config.h */
+    size_type grain(const Operation &op, const size_type &elementSize) const;
+
+    /* Return the epsilon of the context */
+    inline double epsilon() const { return _eps; }
+
+    /* Return the crossover of Strassen-Winograd, 0 means it is disabled */
+    inline size_type strassenCrossover() const { return _strassenCrossover; }
+
+    /* Return whether the floating-point products may use Strassen-Winograd */
+    inline bool strassenFloatingPoint() const { return _strassenFloatingPoint; }
+
+    /* Return the thread pool of the context */
+    inline ThreadPool &threadPool() const { return *_threadPool; }
+
+private:
+    void clearGrainTable();
+
+    std::unique_ptr<ThreadPool> ownedThreadPool;
+    ThreadPool *_threadPool;
+    size_type _limit;
+    double _eps;
+    size_type _strassenCrossover = DEFAULT_STRASSEN_CROSSOVER;
+    bool _strassenFloatingPoint  = false;
+    /* the grains set by setGrain(), calibrate() or loadGrainTable(), 0 means not set */
+    size_type _grain[OPERATION_NUM][ELEMENT_SIZE_CLASS_NUM] = {};
+};
+
+/* Install a context as the current context of the calling thread
+ * the previous context will be the current one again when the object is destroyed */
+class ScopedExecutionContext {
+public:
+    explicit ScopedExecutionContext(ExecutionContext &context);
+
+    ScopedExecutionContext(const ScopedExecutionContext &)            = delete;
+    ScopedExecutionContext &operator=(const ScopedExecutionContext &) = delete;
+
+    ~ScopedExecutionContext();
+
+private:
+    ExecutionContext *previous;
+};
+
+/* Return the context which is used when no context is installed
+ * it uses ThreadPool::getInstance() */
+extern ExecutionContext &defaultContext();
+
+/* Return the context installed by the innermost ScopedExecutionContext of the calling thread,
+ * or defaultContext() when there is none */
+extern ExecutionContext &currentContext();
+
+template <class Function>
+decltype(auto) ExecutionContext::run(Function &&function) {
+    ScopedExecutionContext scope(*this);
+    return std::forward<Function>(function)();
+}
+}  // namespace mca
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef MCA_EXPRESSION_H
+#define MCA_EXPRESSION_H
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "__mca_internal/calculation_task_num.h"
+#include "__mca_internal/elementwise.h"
+#include "__mca_internal/matrix_declaration.h"
+#include "__mca_internal/operation.h"
+#include "__mca_internal/utility.h"
+#include "shape.h"
+
+/* the elements of an expression do not depend on each other, so its loop can be vectorized
+ * even when the output is one of its matrices */
+#if defined(__clang__)
+#define MCA_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define MCA_IVDEP _Pragma("GCC ivdep")
+#else
+#define MCA_IVDEP
+#endif
+
+namespace mca {
+/* The element-wise expressions are evaluated lazily
+ * Lazy(a) wraps a matrix, and +, - of the expressions and the matrices, and +, -, *, / of
+ * the expressions and the numbers build a tree instead of calculating, which is evaluated
+ * in one pass with multi-thread when it is assigned to a matrix, see evaluate()
+ * an element of a node is calculated in the common type of its operands like the operators of
+ * the matrices, so the results are the same as the eager ones
+ * the matrices are referred to, except the temporary ones, which are moved into the tree
+ * NOTE: * and / of two matrices are not element-wise, so they are not in the expressions */
+template <class T>
+class _MatrixExpression {
+public:
+    using value_type = T;
+
+    inline explicit _MatrixExpression(const Matrix<T> &matrix)
+        : _shape(matrix.shape()), _data(matrix.data()) {}
+    inline explicit _MatrixExpression(Matrix<T> &&matrix)
+        : _owner(std::make_shared<const Matrix<T>>(std::move(matrix))),
+          _shape(_owner->shape()),
+          _data(_owner->data()) {}
+
+    inline const Shape &shape() const { return _shape; }
+
+    inline const value_type &operator[](const std::size_t &i) const { return _data[i]; }
+
+private:
+    std::shared_ptr<const Matrix<T>> _owner;
+    Shape _shape;
+    const value_type *_data;
+};
+
+template <class Number>
+class _NumberExpression {
+public:
+    using value_type = Number;
+
+    inline explicit _NumberExpression(const Number &number) : _number(number) {}
+
+    inline const value_type &operator[](const std::size_t &) const { return _number; }
+
+private:
+    Number _number;
+};
+
+template <class T>
+struct is_expression : std::false_type {};
+template <class T>
+struct is_expression<_MatrixExpression<T>> : std::true_type {};
+
+template <ElementwiseOperator OP, class Left, class Right>
+class _BinaryExpression;
+template <ElementwiseOperator OP, class Left, class Right>
+struct is_expression<_BinaryExpression<OP, Left, Right>> : std::true_type {};
+
+// Check if a type is an element-wise expression
+template <class T>
+inline constexpr bool is_expression_v = is_expression<T>::value;
+
+template <ElementwiseOperator OP, class Left, class Right>
+class _BinaryExpression {
+public:
+    using value_type = std::common_type_t<typename Left::value_type, typename Right::value_type>;
+
+    inline _BinaryExpression(Left left, Right right)
+        : _left(std::move(left)), _right(std::move(right)) {
+        if constexpr (is_expression_v<Left> && is_expression_v<Right>) {
+            assert(_left.shape() == _right.shape());
+        }
+    }
+
+    inline const Shape &shape() const {
+        if constexpr (is_expression_v<Left>) {
+            return _left.shape();
+        } else {
+            return _right.shape();
+        }
+    }
+
+    inline value_type operator[](const std::size_t &i) const {
+        const value_type x = static_cast<value_type>(_left[i]);
+        const value_type y = static_cast<value_type>(_right[i]);
+        if constexpr (OP == ElementwiseOperator::ADD) {
+            return x + y;
+        } else if constexpr (OP == ElementwiseOperator::SUBTRACT) {
+            return x - y;
+        } else if constexpr (OP == ElementwiseOperator::MULTIPLY) {
+            return x * y;
+        } else {
+            return x / y;
+        }
+    }
+
+private:
+    Left _left;
+    Right _right;
+};
+
+/* Wrap the matrix a into an expression, see _MatrixExpression
+ * for example: Matrix<double> c = Lazy(a) * 2 + b - 1 */
+template <class T>
+inline _MatrixExpression<T> Lazy(const Matrix<T> &a) {
+    return _MatrixExpression<T>(a);
+}
+template <class T>
+inline _MatrixExpression<T> Lazy(Matrix<T> &&a) {
+    return _MatrixExpression<T>(std::move(a));
+}
+
+/* The operand of an expression: an expression is itself, a matrix is wrapped by Lazy(),
+ * and a number is wrapped by _NumberExpression */
+template <class Operand>
+inline auto expressionOperand(Operand &&operand) {
+    using Type = std::decay_t<Operand>;
+    if constexpr (is_expression_v<Type>) {
+        return Type(std::forward<Operand>(operand));
+    } else if constexpr (is_matrix_v<Type>) {
+        return Lazy(std::forward<Operand>(operand));
+    } else {
+        return _NumberExpression<Type>(operand);
+    }
+}
+
+template <ElementwiseOperator OP, class Left, class Right>
+inline auto makeExpression(Left &&left, Right &&right) {
+    auto x = expressionOperand(std::forward<Left>(left));
+    auto y = expressionOperand(std::forward<Right>(right));
+    return _BinaryExpression<OP, decltype(x), decltype(y)>(std::move(x), std::move(y));
+}
+
+// the operators take an expression and an expression or a matrix, or an expression and a number
+template <class Left, class Right>
+inline constexpr bool is_expression_operands_v =
+    (is_expression_v<std::decay_t<Left>> &&
+     (is_expression_v<std::decay_t<Right>> || is_matrix_v<std::decay_t<Right>>)) ||
+    (is_matrix_v<std::decay_t<Left>> && is_expression_v<std::decay_t<Right>>);
+template <class Left, class Right>
+inline constexpr bool is_expression_number_operands_v =
+    (is_expression_v<std::decay_t<Left>> && !is_matrix_v<std::decay_t<Right>> &&
+     !is_expression_v<std::decay_t<Right>>) ||
+    (is_expression_v<std::decay_t<Right>> && !is_matrix_v<std::decay_t<Left>> &&
+     !is_expression_v<std::decay_t<Left>>);
+
+template <class Left,
+          class Right,
+          class = std::enable_if_t<is_expression_operands_v<Left, Right> ||
+                                   is_expression_number_operands_v<Left, Right>>>
+inline auto operator+(Left &&left, Right &&right) {
+    return makeExpression<ElementwiseOperator::ADD>(std::forward<Left>(left),
+                                                    std::forward<Right>(right));
+}
+
+template <class Left,
+          class Right,
+          class = std::enable_if_t<is_expression_operands_v<Left, Right> ||
+                                   is_expression_number_operands_v<Left, Right>>>
+inline auto operator-(Left &&left, Right &&right) {
+    return makeExpression<ElementwiseOperator::SUBTRACT>(std::forward<Left>(left),
+                                                         std::forward<Right>(right));
+}
+
+template <class Left,
+          class Right,
+          class = std::enable_if_t<is_expression_number_operands_v<Left, Right>>>
+inline auto operator*(Left &&left, Right &&right) {
+    return makeExpression<ElementwiseOperator::MULTIPLY>(std::forward<Left>(left),
+                                                         std::forward<Right>(right));
+}
+
+template <class Left,
+          class Right,
+          class = std::enable_if_t<is_expression_number_operands_v<Left, Right>>>
+inline auto operator/(Left &&left, Right &&right) {
+    return makeExpression<ElementwiseOperator::DIVIDE>(std::forward<Left>(left),
+                                                       std::forward<Right>(right));
+}
+
+/* Evaluate the expression with multi-thread, and store the result in output
+ * every element is calculated through the whole tree and written once, so the matrices are read
+ * in one pass, instead of one pass for every operator
+ * output may be one of the matrices of the expression, because the element i of the result
+ * only reads the elements i of the matrices, so the eager evaluation is never needed
+ * NOTE: output must have the same shape as the expression
+ *       the elements are cast into O by using static_cast */
+template <class E, class O, class = std::enable_if_t<is_expression_v<E>>>
+void evaluate(const E &expression, Matrix<O> &output) {
+    assert(expression.shape() == output.shape());
+    using CommonType = std::common_type_t<typename E::value_type, O>;
+    calculationHelper(Operation::MATRIX_ADDITION,
+                      output.size(),
+                      threadCalculationTaskNum<CommonType>(Operation::MATRIX_ADDITION,
+                                                           output.size()),
+                      nullptr,
+                      [&expression, &output](const std::size_t &start, const std::size_t &len) {
+                          O *target = output.data();
+                          MCA_IVDEP
+                          for (std::size_t i = start; i < start + len; i++) {
+                              target[i] = static_cast<O>(expression[i]);
+                          }
+                      });
+}
+}  // namespace mca
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef MCA_MATRIX_H
 #define MCA_MATRIX_H
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -14,6 +15,7 @@
 #include "__mca_internal/matrix_declaration.h"
 #include "__mca_internal/single_thread_matrix_calculation.h"
 #include "diag.h"
+#include "expression.h"
 #include "identity_matrix.h"
 #include "mca.h"
 #include "mca/__mca_internal/utility.h"
@@ -47,7 +49,8 @@ public:
         size_type totalCalculation = std::min(rows(), columns());
         calculationHelper(Operation::MATRIX_CONSTRUCT_IDENTITY,
                           totalCalculation,
-                          threadCalculationTaskNum(totalCalculation),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_CONSTRUCT_IDENTITY, totalCalculation),
                           nullptr,
                           [this](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -62,7 +65,8 @@ public:
         allocateMemory(Shape(init.size(), init.size() == 0 ? 0 : init.begin()->size()));
         calculationHelper(Operation::MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST,
                           size(),
-                          threadCalculationTaskNum(size()),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_CONSTRUCT_FROM_INITIALIZER_LIST, size()),
                           nullptr,
                           [this, &init](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -77,7 +81,8 @@ public:
         allocateMemory(Shape(init.size(), init.size() == 0 ? 0 : init.begin()->size()));
         calculationHelper(Operation::MATRIX_CONSTRUCT_FROM_VECTOR,
                           size(),
-                          threadCalculationTaskNum(size()),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_CONSTRUCT_FROM_VECTOR, size()),
                           nullptr,
                           [this, &init](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -95,7 +100,8 @@ public:
         size_type actualLen = std::min(size(), len);
         calculationHelper(Operation::MATRIX_CONSTRUCT_FROM_POINTER,
                           actualLen,
-                          threadCalculationTaskNum(actualLen),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_CONSTRUCT_FROM_POINTER, actualLen),
                           nullptr,
                           [this, &data, &actualLen](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -133,7 +139,8 @@ public:
         fill(value_type());
         calculationHelper(Operation::MATRIX_CONSTRUCT_DIAG,
                           rows(),
-                          threadCalculationTaskNum(rows()),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_CONSTRUCT_DIAG, rows()),
                           nullptr,
                           [this, &diag](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -151,6 +158,13 @@ public:
     }
     inline Matrix(const Matrix &other) { *this = other; }
 
+    /* Construct a matrix by evaluating an element-wise expression in one pass, see expression.h
+     * for example: Matrix<double> c = Lazy(a) * 2 + b - 1 */
+    template <class E, class = std::enable_if_t<is_expression_v<E>>>
+    inline Matrix(const E &expression) {
+        *this = expression;
+    }
+
     /* Move constructor
      * NOTE: only those which have the same value_type can use move constructor
      */
@@ -172,7 +186,8 @@ public:
         allocateMemory(other.shape());
         calculationHelper(Operation::MATRIX_COPY_ASSIGNMENT,
                           size(),
-                          threadCalculationTaskNum(size()),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_COPY_ASSIGNMENT, size()),
                           nullptr,
                           [this, &other](const size_type &start, const size_type &len) {
                               for (size_type i = start; i < start + len; i++) {
@@ -183,6 +198,15 @@ public:
     }
     inline Matrix &operator=(const Matrix &other) { return operator=<value_type>(other); }
 
+    /* Evaluate an element-wise expression in one pass, and store the result in the matrix
+     * the expression may refer to the matrix itself, see evaluate() */
+    template <class E, class = std::enable_if_t<is_expression_v<E>>>
+    inline Matrix &operator=(const E &expression) {
+        allocateMemory(expression.shape());
+        evaluate(expression, *this);
+        return *this;
+    }
+
     /* Get the reference to the element of i-th row, j-th column */
     inline reference get(const size_type &i, const size_type &j) {
         assert(i < rows() && j < columns());
@@ -233,7 +257,8 @@ public:
     inline void fill(const_reference value, const size_type &pos = 0) {
         calculationHelper(Operation::MATRIX_FILL,
                           size() - pos,
-                          threadCalculationTaskNum(size() - pos),
+                          threadCalculationTaskNum<value_type>(
+                              Operation::MATRIX_FILL, size() - pos),
                           nullptr,
                           [this, &value, &pos](const size_type &start, const size_type &len) {
                               std::fill(data() + pos + start, data() + pos + start + len, value);
@@ -307,30 +332,44 @@ public:
     /* Check if the matrix is a square matrix */
     inline bool square() const noexcept { return rows() == columns(); }
 
-    /* Check if the matrix is symmetric with multi-thread */
+    /* Check if the matrix is symmetric with multi-thread
+     * the pairs of the blocks mirrored across the diagonal are shared by the threads,
+     * and only the strict upper triangle is compared with its mirror */
     inline bool symmetric() const {
         if (!square()) { return false; }
+        const TrianglePairs pairs    = transposeBlockPairs<value_type>(rows());
+        const CalculationTaskNum res = tileCalculationTaskNum(
+            threadCalculationTaskNum<value_type>(Operation::MATRIX_SYMMETRIC, size()),
+            pairs.pairNum());
         bool result = false;
         calculationHelper(Operation::MATRIX_SYMMETRIC,
-                          size(),
-                          threadCalculationTaskNum(size()),
+                          pairs.pairNum(),
+                          res,
                           result,
-                          [this](const size_type &start, const size_type &len) {
-                              return symmetricSingleThread(*this, start, len);
+                          [this](const size_type &start,
+                                 const size_type &len,
+                                 const std::atomic<bool> *stop) {
+                              return symmetricBlockPairsSingleThread(*this, start, len, stop);
                           });
         return result;
     }
 
-    /* Check if the matrix is antisymmetric with multi-thread */
+    /* Check if the matrix is antisymmetric with multi-thread, see symmetric() */
     inline bool antisymmetric() const {
         if (!square()) { return false; }
+        const TrianglePairs pairs    = transposeBlockPairs<value_type>(rows());
+        const CalculationTaskNum res = tileCalculationTaskNum(
+            threadCalculationTaskNum<value_type>(Operation::MATRIX_ANTISYMMETRIC, size()),
+            pairs.pairNum());
         bool result = false;
         calculationHelper(Operation::MATRIX_ANTISYMMETRIC,
-                          size(),
-                          threadCalculationTaskNum(size()),
+                          pairs.pairNum(),
+                          res,
                           result,
-                          [this](const size_type &start, const size_type &len) {
-                              return antisymmetricSingleThread(*this, start, len);
+                          [this](const size_type &start,
+                                 const size_type &len,
+                                 const std::atomic<bool> *stop) {
+                              return antisymmetricBlockPairsSingleThread(*this, start, len, stop);
                           });
         return result;
     }
@@ -1,17 +1,23 @@
 #ifndef MCA_MCA_H
 #define MCA_MCA_H
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "__mca_internal/calculation_task_num.h"
 #include "__mca_internal/matrix_declaration.h"
+#include "__mca_internal/matrix_multiplication.h"
 #include "__mca_internal/single_thread_matrix_calculation.h"
 #include "__mca_internal/thread_pool.h"
+#include "__mca_internal/transpose.h"
 #include "__mca_internal/utility.h"
+#include "execution_context.h"
 #include "identity_matrix.h"
 #include "shape.h"
 
@@ -191,7 +197,63 @@ inline Matrix<std::common_type_t<T, Number>> operator/(const Matrix<T> &a, const
 template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline Matrix<std::common_type_t<T, Number>> operator/(const Number &number, const Matrix<T> &a);
 
+/* The overloads of +, -, * and / which take an expiring matrix, e.g. a temporary result,
+ * calculate the result in its elements and move them out, instead of allocating another matrix
+ * they are used when the value_type of the expiring matrix is the common type,
+ * otherwise the overloads above are used, and the results are the same
+ * for example: (a + b) - c + 2.0 allocates one matrix for a + b, which is reused by - c and + 2.0
+ * NOTE: the product of two matrices always allocates its result */
+template <class T, class U, class = std::enable_if_t<is_reusable_v<T, U>>>
+inline Matrix<T> operator+(Matrix<T> &&a, const Matrix<U> &b);
+template <class U, class T, class = std::enable_if_t<is_reusable_v<T, U>>>
+inline Matrix<T> operator+(const Matrix<U> &a, Matrix<T> &&b);
+template <class T1,
+          class T2,
+          class = std::enable_if_t<is_reusable_v<T1, T2> || is_reusable_v<T2, T1>>>
+inline Matrix<std::common_type_t<T1, T2>> operator+(Matrix<T1> &&a, Matrix<T2> &&b);
+template <class T, class U, class = std::enable_if_t<is_reusable_v<T, U>>>
+inline Matrix<T> operator-(Matrix<T> &&a, const Matrix<U> &b);
+template <class U, class T, class = std::enable_if_t<is_reusable_v<T, U>>>
+inline Matrix<T> operator-(const Matrix<U> &a, Matrix<T> &&b);
+template <class T1,
+          class T2,
+          class = std::enable_if_t<is_reusable_v<T1, T2> || is_reusable_v<T2, T1>>>
+inline Matrix<std::common_type_t<T1, T2>> operator-(Matrix<T1> &&a, Matrix<T2> &&b);
+template <class T,
+          class Number,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator+(Matrix<T> &&a, const Number &number);
+template <class Number,
+          class T,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator+(const Number &number, Matrix<T> &&a);
+template <class T,
+          class Number,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator-(Matrix<T> &&a, const Number &number);
+template <class Number,
+          class T,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator-(const Number &number, Matrix<T> &&a);
+template <class T,
+          class Number,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator*(Matrix<T> &&a, const Number &number);
+template <class Number,
+          class T,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator*(const Number &number, Matrix<T> &&a);
+template <class T,
+          class Number,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator/(Matrix<T> &&a, const Number &number);
+template <class Number,
+          class T,
+          class = std::enable_if_t<!is_matrix_v<Number> && is_reusable_v<T, Number>>>
+inline Matrix<T> operator/(const Number &number, Matrix<T> &&a);
+
 /* Calculate a += b using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: a's shape must be same with b'shape
  *       the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
@@ -199,6 +261,7 @@ template <class T1, class T2>
 inline void operator+=(Matrix<T1> &a, const Matrix<T2> &b);
 
 /* Calculate a -= b using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: a's shape must be same with b'shape
  *       the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
@@ -213,54 +276,112 @@ template <class T1, class T2>
 inline void operator*=(Matrix<T1> &a, const Matrix<T2> &b);
 
 /* Calculate a += number using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator+=(Matrix<T> &a, const Number &number);
 
 /* Calculate number += a using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator+=(const Number &number, Matrix<T> &a);
 
 /* Calculate a -= number using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator-=(Matrix<T> &a, const Number &number);
 
 /* Calculate number -= a using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator-=(const Number &number, Matrix<T> &a);
 
 /* Calculate a *= number using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator*=(Matrix<T> &a, const Number &number);
 
 /* Calculate number *= a using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator*=(const Number &number, Matrix<T> &a);
 
 /* Calculate a /= number using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator/=(Matrix<T> &a, const Number &number);
 
 /* Calculate number /= a using multi-thread, the result will be stored in a
+ * the elements are calculated in place, and no matrix is allocated
  * NOTE: the calculation will first calculate as std::common_type<T1, T2>
  *       then use static_cast<T1> */
 template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
 inline void operator/=(const Number &number, Matrix<T> &a);
 
-/* Transpose a in place using multi-thread
+/* Calculate a + b using multi-thread, and store the result in output
+ * output may be a or b, and no matrix is allocated
+ * NOTE: a, b and output must have the same shape
+ *       the calculation will first calculate as std::common_type<T1, T2, O>
+ *       then use static_cast<O> */
+template <class T1, class T2, class O>
+void add(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output);
+
+/* Calculate a - b using multi-thread, and store the result in output
+ * output may be a or b, and no matrix is allocated
+ * NOTE: a, b and output must have the same shape
+ *       the calculation will first calculate as std::common_type<T1, T2, O>
+ *       then use static_cast<O> */
+template <class T1, class T2, class O>
+void subtract(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output);
+
+/* Calculate the product a * b using multi-thread, and store the result in output
+ * the product is written into output without allocation, see multiplyMatrix(),
+ * but when output is a or b, the product is calculated in another matrix and moved into output
+ * NOTE: a.columns() must be equal to b.rows(), and output must be a.rows() x b.columns()
+ *       the calculation will first calculate as std::common_type<T1, T2, O>
+ *       then use static_cast<O> */
+template <class T1, class T2, class O>
+void multiply(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output);
+
+/* Calculate a op number or number op a using multi-thread, and store the result in output
+ * output may be a, and no matrix is allocated
+ * NOTE: a and output must have the same shape
+ *       the calculation will first calculate as std::common_type<T, Number, O>
+ *       then use static_cast<O> */
+template <class T, class Number, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void add(const Matrix<T> &a, const Number &number, Matrix<O> &output);
+template <class Number, class T, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void add(const Number &number, const Matrix<T> &a, Matrix<O> &output);
+template <class T, class Number, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void subtract(const Matrix<T> &a, const Number &number, Matrix<O> &output);
+template <class Number, class T, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void subtract(const Number &number, const Matrix<T> &a, Matrix<O> &output);
+template <class T, class Number, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void multiply(const Matrix<T> &a, const Number &number, Matrix<O> &output);
+template <class Number, class T, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void multiply(const Number &number, const Matrix<T> &a, Matrix<O> &output);
+template <class T, class Number, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void divide(const Matrix<T> &a, const Number &number, Matrix<O> &output);
+template <class Number, class T, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void divide(const Number &number, const Matrix<T> &a, Matrix<O> &output);
+
+/* Transpose a in place without allocating another matrix
+ * a square matrix is transposed by swapping the pairs of the blocks mirrored across the diagonal
+ * using multi-thread, and the others by following the cycles of the positions in one thread,
+ * which needs a bitmap of a.size() bits
  * for example: a = [[1, 2, 3],
  *                   [2, 3, 4]]
  *              transpose(a)
@@ -271,6 +392,7 @@ template <class T>
 void transpose(Matrix<T> &a);
 
 /* Store the transposed matrix of a in output using multi-thread
+ * a is partitioned into 2D tiles, and the tiles are transposed block by block
  * NOTE: output must have the same shape with the matrix after transposition
  *       If O and T are not same, all the elements will first be cast to
  *       std::common_type<O, T>, after calculation they will be cast into O
@@ -306,6 +428,9 @@ void pow(Matrix<T> &a, const size_type &exponent);
  *       If O and T are not same, all the elements will first be cast to
  *       std::common_type<O, T>, after calculation they will be cast into O
  *       by using static_cast
+ * the power is squared from the highest bit of exponent and multiplied by a for the 1 bits,
+ * the products are written into output and one more matrix in turn, and no identity matrix
+ * is multiplied, but when O is not the common type, both of them are the matrices of it
  * for example: a = [[1, 2, 3],
  *                   [2, 3, 4],
  *                   [7, 8, 9]]
@@ -319,6 +444,29 @@ void pow(Matrix<T> &a, const size_type &exponent);
 template <class T, class O, class = std::enable_if_t<!is_matrix_v<size_type>>>
 void pow(const Matrix<T> &a, const size_type &exponent, Matrix<O> &output);
 
+/* Calculate the exponentiation of a square integer matrix modulo modulus,
+ * and store the result in output
+ * The function whose parameters do not include output will change the matrix a
+ * every element of the result is in [0, modulus), and it is exact however large the power is,
+ * the negative elements of a are reduced to their residues first
+ * the products are calculated by a blocked GEMM of the residues, whose sums are reduced
+ * by Barrett reduction once for every batch of products that cannot overflow 64 bits
+ * NOTE: Matrix a must be a square matrix of integers
+ *       output must have the same shape as the matrix a
+ *       modulus must be in [1, 2^32], and the residues are cast into O by using static_cast
+ * for example: a = [[1, 1],
+ *                   [1, 0]]
+ *              powMod(a, 90, 1000000007, output)
+ *              output: [[F(91) mod 1000000007, F(90) mod 1000000007],
+ *                       [F(90) mod 1000000007, F(89) mod 1000000007]] */
+template <class T, class O>
+void powMod(const Matrix<T> &a,
+            const size_type &exponent,
+            const std::uint64_t &modulus,
+            Matrix<O> &output);
+template <class T>
+void powMod(Matrix<T> &a, const size_type &exponent, const std::uint64_t &modulus);
+
 /* Calculate number ^ elements of the matrix a, and store the result in output
  * The function whose parameters do not include output will change the matrix a
  * NOTE: output must have the same shape as matrix a
@@ -359,16 +507,59 @@ void powNumber(const Matrix<T> &a, const Number &number, Matrix<O> &output);
 template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
 void powNumber(Matrix<T> &a, const Number &number);
 
+/* The overloads which take a context calculate in the context,
+ * instead of the current context of the calling thread
+ * to calculate with the operators in a context, use ExecutionContext::run()
+ * for example: ExecutionContext context(4);
+ *              transpose(context, a, output)
+ *              Matrix<int> c = context.run([&]() { return a * b; }) */
+template <class T>
+void transpose(ExecutionContext &context, Matrix<T> &a);
+template <class T, class O>
+void transpose(ExecutionContext &context, const Matrix<T> &a, Matrix<O> &output);
+template <class T>
+void pow(ExecutionContext &context, Matrix<T> &a, const size_type &exponent);
+template <class T, class O>
+void pow(ExecutionContext &context,
+         const Matrix<T> &a,
+         const size_type &exponent,
+         Matrix<O> &output);
+template <class T, class O>
+void powMod(ExecutionContext &context,
+            const Matrix<T> &a,
+            const size_type &exponent,
+            const std::uint64_t &modulus,
+            Matrix<O> &output);
+template <class T>
+void powMod(ExecutionContext &context,
+            Matrix<T> &a,
+            const size_type &exponent,
+            const std::uint64_t &modulus);
+template <class Number, class T, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void numberPow(ExecutionContext &context, const Number &number, Matrix<T> &a, Matrix<O> &output);
+template <class Number, class T, class = std::enable_if_t<!is_matrix_v<Number>>>
+void numberPow(ExecutionContext &context, const Number &number, Matrix<T> &a);
+template <class T, class Number, class O, class = std::enable_if_t<!is_matrix_v<Number>>>
+void powNumber(ExecutionContext &context,
+               const Matrix<T> &a,
+               const Number &number,
+               Matrix<O> &output);
+template <class T, class Number, class = std::enable_if_t<!is_matrix_v<Number>>>
+void powNumber(ExecutionContext &context, Matrix<T> &a, const Number &number);
+
 template <class T1, class T2>
 inline bool operator==(const Matrix<T1> &a, const Matrix<T2> &b) {
     if (a.shape() != b.shape()) { return false; }
     bool result = false;
     calculationHelper(Operation::MATRIX_EQUALITY,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_EQUALITY, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return equalSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return equalSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
@@ -379,10 +570,13 @@ inline bool operator!=(const Matrix<T1> &a, const Matrix<T2> &b) {
     bool result = false;
     calculationHelper(Operation::MATRIX_INEQUALITY,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_INEQUALITY, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return notEqualSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return notEqualSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
@@ -393,10 +587,13 @@ inline bool operator<(const Matrix<T1> &a, const Matrix<T2> &b) {
     bool result = false;
     calculationHelper(Operation::MATRIX_LESS,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_LESS, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return lessSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return lessSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
@@ -407,10 +604,13 @@ inline bool operator<=(const Matrix<T1> &a, const Matrix<T2> &b) {
     bool result = false;
     calculationHelper(Operation::MATRIX_LESS_EQUAL,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_LESS_EQUAL, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return lessEqualSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return lessEqualSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
@@ -421,10 +621,13 @@ inline bool operator>(const Matrix<T1> &a, const Matrix<T2> &b) {
     bool result = false;
     calculationHelper(Operation::MATRIX_GREATER,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_GREATER, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return greaterSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return greaterSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
@@ -435,41 +638,162 @@ inline bool operator>=(const Matrix<T1> &a, const Matrix<T2> &b) {
     bool result = false;
     calculationHelper(Operation::MATRIX_GREATER_EQUAL,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<std::common_type_t<T1, T2>>(
+                          Operation::MATRIX_GREATER_EQUAL, a.size()),
                       result,
-                      [&a, &b](const size_t &start, const size_t &len) {
-                          return greaterEqualSingleThread(a, b, start, len);
+                      [&a, &b](const size_t &start,
+                               const size_t &len,
+                               const std::atomic<bool> *stop) {
+                          return greaterEqualSingleThread(a, b, start, len, stop);
                       });
     return result;
 }
 
-template <class T1, class T2>
-inline Matrix<std::common_type_t<T1, T2>> operator+(const Matrix<T1> &a, const Matrix<T2> &b) {
+template <class T1, class T2, class O>
+inline void add(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output) {
     assert(a.shape() == b.shape());
-    using CommonType = std::common_type_t<T1, T2>;
-    Matrix<CommonType> result(a.shape());
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T1, T2, O>;
     calculationHelper(Operation::MATRIX_ADDITION,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<CommonType>(Operation::MATRIX_ADDITION, a.size()),
                       nullptr,
-                      [&a, &b, &result](const size_t &start, const size_t &len) {
-                          addSingleThread(a, b, result, start, len);
+                      [&a, &b, &output](const size_t &start, const size_t &len) {
+                          addSingleThread(a, b, output, start, len);
                       });
-    return result;
 }
 
-template <class T1, class T2>
-inline Matrix<std::common_type_t<T1, T2>> operator-(const Matrix<T1> &a, const Matrix<T2> &b) {
+template <class T1, class T2, class O>
+inline void subtract(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output) {
     assert(a.shape() == b.shape());
-    using CommonType = std::common_type_t<T1, T2>;
-    Matrix<CommonType> result(a.shape());
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T1, T2, O>;
     calculationHelper(Operation::MATRIX_SUBTRACTION,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<CommonType>(Operation::MATRIX_SUBTRACTION, a.size()),
+                      nullptr,
+                      [&a, &b, &output](const size_t &start, const size_t &len) {
+                          subtractSingleThread(a, b, output, start, len);
+                      });
+}
+
+template <class T1, class T2, class O>
+inline void multiply(const Matrix<T1> &a, const Matrix<T2> &b, Matrix<O> &output) {
+    assert(a.columns() == b.rows());
+    assert(output.rows() == a.rows() && output.columns() == b.columns());
+    if (static_cast<const void *>(&a) == static_cast<const void *>(&output) ||
+        static_cast<const void *>(&b) == static_cast<const void *>(&output)) {
+        output = Matrix<O>(multiplyMatrix<std::common_type_t<T1, T2, O>>(a, b));
+        return;
+    }
+    multiplyMatrix(a, b, output);
+}
+
+template <class T, class Number, class O, class>
+inline void add(const Matrix<T> &a, const Number &number, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::MATRIX_NUMBER_ADDITION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::MATRIX_NUMBER_ADDITION, a.size()),
                       nullptr,
-                      [&a, &b, &result](const size_t &start, const size_t &len) {
-                          subtractSingleThread(a, b, result, start, len);
+                      [&a, &number, &output](const size_t &start, const size_t &len) {
+                          addSingleThread(number, a, output, start, len);
                       });
+}
+
+template <class Number, class T, class O, class>
+inline void add(const Number &number, const Matrix<T> &a, Matrix<O> &output) {
+    add(a, number, output);
+}
+
+template <class T, class Number, class O, class>
+inline void subtract(const Matrix<T> &a, const Number &number, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::MATRIX_NUMBER_SUBTRACTION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::MATRIX_NUMBER_SUBTRACTION, a.size()),
+                      nullptr,
+                      [&a, &number, &output](const size_t &start, const size_t &len) {
+                          subtractSingleThread(a, number, output, start, len);
+                      });
+}
+
+template <class Number, class T, class O, class>
+inline void subtract(const Number &number, const Matrix<T> &a, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::NUMBER_MATRIX_SUBTRACTION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::NUMBER_MATRIX_SUBTRACTION, a.size()),
+                      nullptr,
+                      [&number, &a, &output](const size_t &start, const size_t &len) {
+                          subtractSingleThread(number, a, output, start, len);
+                      });
+}
+
+template <class T, class Number, class O, class>
+inline void multiply(const Matrix<T> &a, const Number &number, Matrix<O> &output) {
+    multiply(number, a, output);
+}
+
+template <class Number, class T, class O, class>
+inline void multiply(const Number &number, const Matrix<T> &a, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::NUMBER_MATRIX_MULTIPLICATION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::NUMBER_MATRIX_MULTIPLICATION, a.size()),
+                      nullptr,
+                      [&number, &a, &output](const size_t &start, const size_t &len) {
+                          multiplySingleThread(number, a, output, start, len);
+                      });
+}
+
+template <class T, class Number, class O, class>
+inline void divide(const Matrix<T> &a, const Number &number, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::MATRIX_NUMBER_DIVISION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::MATRIX_NUMBER_DIVISION, a.size()),
+                      nullptr,
+                      [&a, &number, &output](const size_t &start, const size_t &len) {
+                          divideSingleThread(a, number, output, start, len);
+                      });
+}
+
+template <class Number, class T, class O, class>
+inline void divide(const Number &number, const Matrix<T> &a, Matrix<O> &output) {
+    assert(a.shape() == output.shape());
+    using CommonType = std::common_type_t<T, Number, O>;
+    calculationHelper(Operation::NUMBER_MATRIX_DIVISION,
+                      a.size(),
+                      threadCalculationTaskNum<CommonType>(
+                          Operation::NUMBER_MATRIX_DIVISION, a.size()),
+                      nullptr,
+                      [&number, &a, &output](const size_t &start, const size_t &len) {
+                          divideSingleThread(number, a, output, start, len);
+                      });
+}
+
+template <class T1, class T2>
+inline Matrix<std::common_type_t<T1, T2>> operator+(const Matrix<T1> &a, const Matrix<T2> &b) {
+    Matrix<std::common_type_t<T1, T2>> result(a.shape());
+    add(a, b, result);
+    return result;
+}
+
+template <class T1, class T2>
+inline Matrix<std::common_type_t<T1, T2>> operator-(const Matrix<T1> &a, const Matrix<T2> &b) {
+    Matrix<std::common_type_t<T1, T2>> result(a.shape());
+    subtract(a, b, result);
     return result;
 }
 
@@ -477,30 +801,13 @@ template <class T1, class T2>
 inline Matrix<std::common_type_t<T1, T2>> operator*(const Matrix<T1> &a, const Matrix<T2> &b) {
     assert(a.columns() == b.rows());
     using CommonType = std::common_type_t<T1, T2>;
-    Matrix<CommonType> result(Shape{a.rows(), b.columns()});
-    auto res        = threadCalculationTaskNum(a.size() * b.columns());
-    res.calculation = result.size() / res.taskNum;
-    calculationHelper(Operation::MATRIX_MULTIPLICATION,
-                      result.size(),
-                      res,
-                      nullptr,
-                      [&a, &b, &result](const size_t &start, const size_t &len) {
-                          multiplySingleThread(a, b, result, start, len);
-                      });
-    return result;
+    return multiplyMatrix<CommonType>(a, b);
 }
 
 template <class T, class Number, class>
 inline Matrix<std::common_type_t<T, Number>> operator+(const Matrix<T> &a, const Number &number) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::MATRIX_NUMBER_ADDITION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&a, &number, &result](const size_t &start, const size_t &len) {
-                          addSingleThread(number, a, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    add(a, number, result);
     return result;
 }
 
@@ -511,29 +818,15 @@ inline Matrix<std::common_type_t<T, Number>> operator+(const Number &number, con
 
 template <class T, class Number, class>
 inline Matrix<std::common_type_t<T, Number>> operator-(const Matrix<T> &a, const Number &number) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::MATRIX_NUMBER_SUBTRACTION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&a, &number, &result](const size_t &start, const size_t &len) {
-                          subtractSingleThread(a, number, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    subtract(a, number, result);
     return result;
 }
 
 template <class Number, class T, class>
 inline Matrix<std::common_type_t<T, Number>> operator-(const Number &number, const Matrix<T> &a) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::NUMBER_MATRIX_SUBTRACTION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&number, &a, &result](const size_t &start, const size_t &len) {
-                          subtractSingleThread(number, a, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    subtract(number, a, result);
     return result;
 }
 
@@ -544,54 +837,123 @@ inline Matrix<std::common_type_t<T, Number>> operator*(const Matrix<T> &a, const
 
 template <class Number, class T, class>
 inline Matrix<std::common_type_t<T, Number>> operator*(const Number &number, const Matrix<T> &a) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::NUMBER_MATRIX_MULTIPLICATION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&number, &a, &result](const size_t &start, const size_t &len) {
-                          multiplySingleThread(number, a, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    multiply(number, a, result);
     return result;
 }
 
 template <class T, class Number, class>
 inline Matrix<std::common_type_t<T, Number>> operator/(const Matrix<T> &a, const Number &number) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::MATRIX_NUMBER_DIVISION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&a, &number, &result](const size_t &start, const size_t &len) {
-                          divideSingleThread(a, number, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    divide(a, number, result);
     return result;
 }
 
 template <class Number, class T, class>
 inline Matrix<std::common_type_t<T, Number>> operator/(const Number &number, const Matrix<T> &a) {
-    using CommonType = std::common_type_t<T, Number>;
-    Matrix<CommonType> result(a.shape());
-    calculationHelper(Operation::NUMBER_MATRIX_DIVISION,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&number, &a, &result](const size_t &start, const size_t &len) {
-                          divideSingleThread(number, a, result, start, len);
-                      });
+    Matrix<std::common_type_t<T, Number>> result(a.shape());
+    divide(number, a, result);
     return result;
 }
 
+template <class T, class U, class>
+inline Matrix<T> operator+(Matrix<T> &&a, const Matrix<U> &b) {
+    add(a, b, a);
+    return std::move(a);
+}
+
+template <class U, class T, class>
+inline Matrix<T> operator+(const Matrix<U> &a, Matrix<T> &&b) {
+    add(a, b, b);
+    return std::move(b);
+}
+
+template <class T1, class T2, class>
+inline Matrix<std::common_type_t<T1, T2>> operator+(Matrix<T1> &&a, Matrix<T2> &&b) {
+    if constexpr (is_reusable_v<T1, T2>) {
+        return std::move(a) + b;
+    } else {
+        return a + std::move(b);
+    }
+}
+
+template <class T, class U, class>
+inline Matrix<T> operator-(Matrix<T> &&a, const Matrix<U> &b) {
+    subtract(a, b, a);
+    return std::move(a);
+}
+
+template <class U, class T, class>
+inline Matrix<T> operator-(const Matrix<U> &a, Matrix<T> &&b) {
+    subtract(a, b, b);
+    return std::move(b);
+}
+
+template <class T1, class T2, class>
+inline Matrix<std::common_type_t<T1, T2>> operator-(Matrix<T1> &&a, Matrix<T2> &&b) {
+    if constexpr (is_reusable_v<T1, T2>) {
+        return std::move(a) - b;
+    } else {
+        return a - std::move(b);
+    }
+}
+
+template <class T, class Number, class>
+inline Matrix<T> operator+(Matrix<T> &&a, const Number &number) {
+    add(a, number, a);
+    return std::move(a);
+}
+
+template <class Number, class T, class>
+inline Matrix<T> operator+(const Number &number, Matrix<T> &&a) {
+    add(number, a, a);
+    return std::move(a);
+}
+
+template <class T, class Number, class>
+inline Matrix<T> operator-(Matrix<T> &&a, const Number &number) {
+    subtract(a, number, a);
+    return std::move(a);
+}
+
+template <class Number, class T, class>
+inline Matrix<T> operator-(const Number &number, Matrix<T> &&a) {
+    subtract(number, a, a);
+    return std::move(a);
+}
+
+template <class T, class Number, class>
+inline Matrix<T> operator*(Matrix<T> &&a, const Number &number) {
+    multiply(a, number, a);
+    return std::move(a);
+}
+
+template <class Number, class T, class>
+inline Matrix<T> operator*(const Number &number, Matrix<T> &&a) {
+    multiply(number, a, a);
+    return std::move(a);
+}
+
+template <class T, class Number, class>
+inline Matrix<T> operator/(Matrix<T> &&a, const Number &number) {
+    divide(a, number, a);
+    return std::move(a);
+}
+
+template <class Number, class T, class>
+inline Matrix<T> operator/(const Number &number, Matrix<T> &&a) {
+    divide(number, a, a);
+    return std::move(a);
+}
+
 template <class T1, class T2>
 inline void operator+=(Matrix<T1> &a, const Matrix<T2> &b) {
-    a = a + b;
+    add(a, b, a);
 }
 
 template <class T1, class T2>
 inline void operator-=(Matrix<T1> &a, const Matrix<T2> &b) {
-    a = a - b;
+    subtract(a, b, a);
 }
 
 template <class T1, class T2>
@@ -601,7 +963,7 @@ inline void operator*=(Matrix<T1> &a, const Matrix<T2> &b) {
 
 template <class T, class Number, class>
 inline void operator+=(Matrix<T> &a, const Number &number) {
-    a = a + number;
+    add(a, number, a);
 }
 
 template <class Number, class T, class>
@@ -611,12 +973,12 @@ inline void operator+=(const Number &number, Matrix<T> &a) {
 
 template <class T, class Number, class>
 inline void operator-=(Matrix<T> &a, const Number &number) {
-    a = a - number;
+    subtract(a, number, a);
 }
 
 template <class Number, class T, class>
 inline void operator-=(const Number &number, Matrix<T> &a) {
-    a = number - a;
+    subtract(number, a, a);
 }
 
 template <class T, class Number, class>
@@ -626,37 +988,56 @@ inline void operator*=(Matrix<T> &a, const Number &number) {
 
 template <class Number, class T, class>
 inline void operator*=(const Number &number, Matrix<T> &a) {
-    a = number * a;
+    multiply(number, a, a);
 }
 
 template <class T, class Number, class>
 inline void operator/=(Matrix<T> &a, const Number &number) {
-    a = a / number;
+    divide(a, number, a);
 }
 
 template <class Number, class T, class>
 inline void operator/=(const Number &number, Matrix<T> &a) {
-    a = number / a;
+    divide(number, a, a);
 }
 
 template <class T>
 inline void transpose(Matrix<T> &a) {
-    Matrix<T> output(Shape{a.columns(), a.rows()});
-    transpose(a, output);
-    a = std::move(output);
+    if (!a.square()) {
+        transposeCycles(a);
+        return;
+    }
+    const TrianglePairs pairs    = transposeBlockPairs<T>(a.rows());
+    const CalculationTaskNum res =
+        threadCalculationTaskNum<T>(Operation::MATRIX_TRANSPOSE, a.size() / 2);
+    calculationHelper(Operation::MATRIX_TRANSPOSE,
+                      pairs.pairNum(),
+                      tileCalculationTaskNum(res, pairs.pairNum()),
+                      nullptr,
+                      [&a, &pairs](const size_t &start, const size_t &len) {
+                          size_t rowBlock = 0, columnBlock = 0;
+                          pairs.pair(start, rowBlock, columnBlock);
+                          for (size_t t = 0; t < len; t++, pairs.next(rowBlock, columnBlock)) {
+                              transposeBlockPair(a, rowBlock, columnBlock);
+                          }
+                      });
 }
 
 template <class T, class O>
 inline void transpose(const Matrix<T> &a, Matrix<O> &output) {
     assert(a.rows() == output.columns());
     assert(a.columns() == output.rows());
-    calculationHelper(Operation::MATRIX_TRANSPOSE,
-                      a.size(),
-                      threadCalculationTaskNum(a.size()),
-                      nullptr,
-                      [&a, &output](const size_t &start, const size_t &len) {
-                          transposeSingleThread(a, output, start, len);
-                      });
+    auto res            = threadCalculationTaskNum<O>(Operation::MATRIX_TRANSPOSE, a.size());
+    const Tiling tiling = transposeTiling<T>(a.rows(), a.columns(), res.taskNum);
+    tileCalculationHelper(Operation::MATRIX_TRANSPOSE,
+                          tiling,
+                          res,
+                          [&a, &output](const size_t &rowBegin,
+                                        const size_t &rowEnd,
+                                        const size_t &columnBegin,
+                                        const size_t &columnEnd) {
+                              transposeBlocked(a, output, rowBegin, rowEnd, columnBegin, columnEnd);
+                          });
 }
 
 template <class T>
@@ -671,24 +1052,91 @@ template <class T, class O, class>
 void pow(const Matrix<T> &a, const size_type &exponent, Matrix<O> &output) {
     assert(a.square());
     assert(a.shape() == output.shape());
-    size_type b = exponent;
-    Matrix<T> temp(a);
-    // make output an identity matrix
-    output = Matrix<O>(output.shape(), IdentityMatrix());
-    while (b > 0) {
-        if (b & 1) { output *= temp; }
-        if ((b >> 1) == 0) { break; }
-        temp *= temp;
-        b >>= 1;
+    if (static_cast<const void *>(&a) == static_cast<const void *>(&output)) {
+        const Matrix<T> base(a);
+        pow(base, exponent, output);
+        return;
+    }
+    if (exponent == 0) {
+        output.fill(O());
+        for (size_type i = 0; i < output.rows(); i++) { output.get(i, i) = O(1); }
+        return;
+    }
+    using CommonType = std::common_type_t<O, T>;
+    if constexpr (!std::is_same_v<O, CommonType>) {
+        // the power is calculated in the common type, and it is cast into output once at the end
+        Matrix<CommonType> power(a.shape());
+        pow(a, exponent, power);
+        for (size_type i = 0; i < output.size(); i++) {
+            output.data()[i] = static_cast<O>(power.data()[i]);
+        }
+        return;
+    }
+    // the bits are read from the highest one, whose power is a itself, then every bit squares
+    // the power, and the 1 bits multiply it by a, so a is never copied or squared on its own
+    size_type bit = 0;
+    while (exponent >> bit > 1) { bit++; }
+    output = a;
+    // the power moves between output and scratch, which are the only matrices written
+    Matrix<O> scratch(a.shape());
+    while (bit-- > 0) {
+        multiplyMatrix(output, output, scratch);
+        if ((exponent >> bit & 1) != 0) {
+            multiplyMatrix(scratch, a, output);
+        } else {
+            std::swap(output, scratch);
+        }
+    }
+}
+
+template <class T, class O>
+void powMod(const Matrix<T> &a,
+            const size_type &exponent,
+            const std::uint64_t &modulus,
+            Matrix<O> &output) {
+    static_assert(std::is_integral_v<T> && std::is_integral_v<O>,
+                  "powMod() only calculates the matrices of integers");
+    assert(a.square());
+    assert(a.shape() == output.shape());
+    const BarrettReduction reduction(modulus);
+    // the residues are std::uint64_t, whose type is named by T, so that Matrix is complete here
+    using Residue = decltype(reduction.residue(T()));
+    // a is reduced before output is written, so output may be a
+    Matrix<Residue> base(a.shape()), power(a.shape());
+    for (size_type i = 0; i < a.size(); i++) { base.data()[i] = reduction.residue(a.data()[i]); }
+    if (exponent == 0) {
+        for (size_type i = 0; i < a.rows(); i++) { power.get(i, i) = reduction.reduce(1); }
+    } else {
+        // the same squaring from the highest bit as pow(), but every product is reduced
+        size_type bit = 0;
+        while (exponent >> bit > 1) { bit++; }
+        power = base;
+        Matrix<Residue> scratch(a.shape());
+        while (bit-- > 0) {
+            gemmModularMultiThread(power, power, scratch, reduction);
+            if ((exponent >> bit & 1) != 0) {
+                gemmModularMultiThread(scratch, base, power, reduction);
+            } else {
+                std::swap(power, scratch);
+            }
+        }
+    }
+    for (size_type i = 0; i < a.size(); i++) {
+        output.data()[i] = static_cast<O>(power.data()[i]);
     }
 }
 
+template <class T>
+inline void powMod(Matrix<T> &a, const size_type &exponent, const std::uint64_t &modulus) {
+    powMod(a, exponent, modulus, a);
+}
+
 template <class Number, class T, class O, class>
 inline void numberPow(const Number &number, Matrix<T> &a, Matrix<O> &output) {
     assert(a.shape() == output.shape());
     calculationHelper(Operation::NUMBER_MATRIX_POW,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<O>(Operation::NUMBER_MATRIX_POW, a.size()),
                       nullptr,
                       [&number, &a, &output](const size_t &start, const size_t &len) {
                           numberPowSingleThread(number, a, output, start, len);
@@ -707,7 +1155,7 @@ inline void powNumber(const Matrix<T> &a, const Number &number, Matrix<O> &outpu
     assert(a.shape() == output.shape());
     calculationHelper(Operation::MATRIX_NUMBER_POW,
                       a.size(),
-                      threadCalculationTaskNum(a.size()),
+                      threadCalculationTaskNum<O>(Operation::MATRIX_NUMBER_POW, a.size()),
                       nullptr,
                       [&a, &number, &output](const size_t &start, const size_t &len) {
                           powNumberSingleThread(a, number, output, start, len);
@@ -720,5 +1168,71 @@ inline void powNumber(Matrix<T> &a, const Number &number) {
     powNumber(a, number, output);
     a = std::move(output);
 }
+
+template <class T>
+inline void transpose(ExecutionContext &context, Matrix<T> &a) {
+    context.run([&a]() { transpose(a); });
+}
+
+template <class T, class O>
+inline void transpose(ExecutionContext &context, const Matrix<T> &a, Matrix<O> &output) {
+    context.run([&a, &output]() { transpose(a, output); });
+}
+
+template <class T>
+inline void pow(ExecutionContext &context, Matrix<T> &a, const size_type &exponent) {
+    context.run([&a, &exponent]() { pow(a, exponent); });
+}
+
+template <class T, class O>
+inline void pow(ExecutionContext &context,
+                const Matrix<T> &a,
+                const size_type &exponent,
+                Matrix<O> &output) {
+    context.run([&a, &exponent, &output]() { pow(a, exponent, output); });
+}
+
+template <class T, class O>
+inline void powMod(ExecutionContext &context,
+                   const Matrix<T> &a,
+                   const size_type &exponent,
+                   const std::uint64_t &modulus,
+                   Matrix<O> &output) {
+    context.run([&a, &exponent, &modulus, &output]() { powMod(a, exponent, modulus, output); });
+}
+
+template <class T>
+inline void powMod(ExecutionContext &context,
+                   Matrix<T> &a,
+                   const size_type &exponent,
+                   const std::uint64_t &modulus) {
+    context.run([&a, &exponent, &modulus]() { powMod(a, exponent, modulus); });
+}
+
+template <class Number, class T, class O, class>
+inline void numberPow(ExecutionContext &context,
+                      const Number &number,
+                      Matrix<T> &a,
+                      Matrix<O> &output) {
+    context.run([&number, &a, &output]() { numberPow(number, a, output); });
+}
+
+template <class Number, class T, class>
+inline void numberPow(ExecutionContext &context, const Number &number, Matrix<T> &a) {
+    context.run([&number, &a]() { numberPow(number, a); });
+}
+
+template <class T, class Number, class O, class>
+inline void powNumber(ExecutionContext &context,
+                      const Matrix<T> &a,
+                      const Number &number,
+                      Matrix<O> &output) {
+    context.run([&a, &number, &output]() { powNumber(a, number, output); });
+}
+
+template <class T, class Number, class>
+inline void powNumber(ExecutionContext &context, Matrix<T> &a, const Number &number) {
+    context.run([&a, &number]() { powNumber(a, number); });
+}
 }  // namespace mca
 #endif
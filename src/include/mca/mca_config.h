@@ -1,8 +1,14 @@
 #ifndef MCA_MCA_CONFIG_H
 #define MCA_MCA_CONFIG_H
 
+#include <string>
+
+#include "__mca_internal/operation.h"
 #include "__mca_internal/thread_pool.h"
+#include "execution_context.h"
 
+/* All the functions below read and write the current execution context of the calling thread,
+ * which is defaultContext() unless another context is installed, see execution_context.h */
 namespace mca {
 using size_type = std::size_t;
 
@@ -10,10 +16,12 @@ using size_type = std::size_t;
  * If you don't call init, mca will run in single thread mode
  * threadNum is how many threads will be used when calculating
  * limit is the minimal quantity of a thread's calculation
- * eps is the epsilon when comparing matrices whose elements' types are floating number */
+ * eps is the epsilon when comparing matrices whose elements' types are floating number
+ * if calibration is true, the grain table will be filled by calibrate() */
 extern void init(const size_type &threadNum = std::thread::hardware_concurrency() - 1,
                  const size_type &limit     = 623,
-                 const double &eps          = 1e-100);
+                 const double &eps          = 1e-100,
+                 const bool &calibration    = false);
 
 /* Set how many threads will be used when calculating */
 extern void setThreadNum(const size_type &threadNum);
@@ -21,22 +29,68 @@ extern void setThreadNum(const size_type &threadNum);
 /* Set the minimal quantity of a thread's calculation
  * Make sure every sub-thread's calculation is no less than limit
  * When the rest part is less than limit, the main thread will calculate the rest
+ * This will clear the grain table, the grains of all the operations will be derived from limit
  * NOTE: if you want to calculate with single thread, you can set the limit with
  *       std::numeric_limits<size_type>::max() */
 extern void setLimit(const size_type &limit);
 
+/* Set the minimal quantity of a thread's calculation of op,
+ * for the elements whose size is elementSize bytes
+ * the elements in the same size class share the grain, see ELEMENT_SIZE_CLASS_NUM
+ * if grain is 0, the grain will be derived from limit again */
+extern void setGrain(const Operation &op, const size_type &elementSize, const size_type &grain);
+
+/* Measure the cost of every operation with the current thread, and fill the grain table
+ * so that a task of every operation takes about the same time
+ * this takes a while, save the table with saveGrainTable() to skip it on later starts */
+extern void calibrate();
+
+/* Save the grain table to the file of path, return false if the file can not be written */
+extern bool saveGrainTable(const std::string &path);
+
+/* Load the grain table from the file of path written by saveGrainTable()
+ * return false and keep the current table if the file can not be read or is invalid */
+extern bool loadGrainTable(const std::string &path);
+
 /* Set the epsilon used for comparing floating numbers */
 extern void setEpsilon(const double &eps);
 
+/* Set the crossover of the Strassen-Winograd multiplication
+ * the product of two n x n matrices is calculated by Strassen-Winograd if n >= crossover:
+ * the matrices are split into the quarters, whose seven products are calculated in parallel,
+ * recursively until the quarters are smaller than crossover
+ * 0 disables Strassen-Winograd, and the other values less than 2 are the same as 2
+ * the default crossover is DEFAULT_STRASSEN_CROSSOVER */
+extern void setStrassenCrossover(const size_type &crossover);
+
+/* Set whether the floating-point products may use Strassen-Winograd, the default is false
+ * the error bound of Strassen-Winograd is weaker than the ordinary multiplication's,
+ * so the floating-point products only use it when it is enabled,
+ * the integer products always may use it, and they are exact */
+extern void setStrassenFloatingPoint(const bool &enabled);
+
 /* Return current thread number */
 extern size_type threadNum();
 
 /* Return current limit */
 extern size_type limit();
 
+/* Return the minimal quantity of a thread's calculation of op,
+ * for the elements whose size is elementSize bytes
+ * if the grain is not set, it is derived from limit:
+ * the operations which only move the elements get 8 times of limit,
+ * the power operations get 1/8 of limit, and the others get limit */
+extern size_type grain(const Operation &op, const size_type &elementSize);
+
 /* Return current epsilon */
 extern double epsilon();
 
+/* Return the current crossover of Strassen-Winograd, 0 means it is disabled */
+extern size_type strassenCrossover();
+
+/* Return whether the floating-point products may use Strassen-Winograd currently */
+extern bool strassenFloatingPoint();
+
 /* Return thread pool object, this should not called by the users, and this is for developers */
 extern ThreadPool &threadPool();
 }  // namespace mca
@@ -0,0 +1,173 @@
+#ifndef MCA_POWER_CACHE_H
+#define MCA_POWER_CACHE_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "__mca_internal/matrix_multiplication.h"
+#include "identity_matrix.h"
+#include "matrix.h"
+#include "mca.h"
+
+namespace mca {
+/* A power cache answers the powers of one square matrix, and keeps the squares A^(2^i)
+ * which it has calculated, so that A^k takes at most popcount(k) multiplications
+ * when the squares of its bits are cached, and a missing square is squared from the nearest
+ * cached one below it
+ * the squares share the memory budget in bytes, and the least recently used ones are evicted
+ * when a new one does not fit, A itself is always kept and is not counted
+ * the factors are multiplied in another order than pow(), so the floating-point powers may differ
+ * from pow()'s in the last bits
+ * NOTE: the matrix is copied, so later changes of it do not change the cache
+ *       the products are calculated in the current context like pow(),
+ *       but a cache must not be used by several threads at the same time */
+template <class T>
+class PowerCache {
+public:
+    using size_type  = std::size_t;
+    using value_type = T;
+
+    /* bind the cache to a copy of the square matrix a, the budget is unlimited by default */
+    inline explicit PowerCache(const Matrix<T> &a,
+                               const size_type &budget = std::numeric_limits<size_type>::max())
+        : PowerCache(Matrix<T>(a), budget) {}
+    inline explicit PowerCache(Matrix<T> &&a,
+                               const size_type &budget = std::numeric_limits<size_type>::max())
+        : _budget(budget) {
+        assert(a.square());
+        _squares.push_back(std::make_shared<const Matrix<T>>(std::move(a)));
+        _lastUse.push_back(0);
+    }
+
+    /* get the matrix which the cache is bound to */
+    inline const Matrix<T> &matrix() const { return *_squares[0]; }
+
+    /* get A^exponent, which is the identity matrix when exponent is 0
+     * the squares of the 1 bits of exponent are multiplied from the lowest bit */
+    inline Matrix<T> pow(const size_type &exponent) {
+        const Shape shape = matrix().shape();
+        if (exponent == 0) { return Matrix<T>(shape, IdentityMatrix()); }
+        Matrix<T> result, scratch;
+        bool first = true;
+        // the last square of the bits, the next ones are squared from it if they are not cached
+        std::shared_ptr<const Matrix<T>> factor = _squares[0];
+        size_type level                         = 0;
+        for (size_type bit = 0; exponent >> bit != 0; bit++) {
+            if ((exponent >> bit & 1) == 0) { continue; }
+            factor = squareFrom(bit, factor, level);
+            level  = bit;
+            if (first) {
+                result = *factor;
+                first  = false;
+            } else {
+                if (scratch.shape() != shape) { scratch = Matrix<T>(shape); }
+                multiplyMatrix(result, *factor, scratch);
+                std::swap(result, scratch);
+            }
+        }
+        return result;
+    }
+
+    /* get A^(2^bit), and cache it and the squares calculated for it if they fit in the budget */
+    inline std::shared_ptr<const Matrix<T>> square(const size_type &bit) {
+        return squareFrom(bit, _squares[0], 0);
+    }
+
+    /* check if A^(2^bit) is cached, A itself always is */
+    inline bool cached(const size_type &bit) const {
+        return bit < _squares.size() && _squares[bit] != nullptr;
+    }
+
+    /* get the bytes which the cached squares take, A itself is not counted */
+    inline size_type memory() const { return _memory; }
+
+    /* get the number of the cached squares, A itself is not counted */
+    inline size_type cachedNum() const {
+        size_type num = 0;
+        for (size_type i = 1; i < _squares.size(); i++) { num += _squares[i] != nullptr; }
+        return num;
+    }
+
+    /* get the memory budget in bytes */
+    inline size_type budget() const { return _budget; }
+
+    /* Set the memory budget in bytes, the least recently used squares are evicted until
+     * the cached ones fit in it */
+    inline void setBudget(const size_type &budget) {
+        _budget = budget;
+        while (_memory > _budget) { evictLeastRecentlyUsed(); }
+    }
+
+    /* Evict all the cached squares except A itself */
+    inline void clear() {
+        _squares.resize(1);
+        _lastUse.resize(1);
+        _memory = 0;
+    }
+
+private:
+    inline size_type squareMemory() const { return matrix().size() * sizeof(T); }
+
+    /* get A^(2^bit) from power, which is A^(2^level) and level <= bit,
+     * it is squared from the highest cached square between them */
+    inline std::shared_ptr<const Matrix<T>> squareFrom(const size_type &bit,
+                                                       std::shared_ptr<const Matrix<T>> power,
+                                                       size_type level) {
+        if (_squares.size() <= bit) {
+            _squares.resize(bit + 1);
+            _lastUse.resize(bit + 1, 0);
+        }
+        for (size_type i = bit; i > level; i--) {
+            if (_squares[i] != nullptr) {
+                power = _squares[i];
+                level = i;
+                break;
+            }
+        }
+        if (_squares[level] != nullptr) { _lastUse[level] = ++_clock; }
+        while (level < bit) {
+            power = std::make_shared<const Matrix<T>>(multiplyMatrix<T>(*power, *power));
+            insert(++level, power);
+        }
+        return power;
+    }
+
+    /* cache the square of bit, the least recently used ones are evicted to make room,
+     * and it is not cached if it does not fit in the budget on its own */
+    inline void insert(const size_type &bit, const std::shared_ptr<const Matrix<T>> &power) {
+        const size_type size = squareMemory();
+        if (size > _budget) { return; }
+        while (_budget - size < _memory) { evictLeastRecentlyUsed(); }
+        _squares[bit] = power;
+        _lastUse[bit] = ++_clock;
+        _memory += size;
+    }
+
+    /* evict the cached square which is used least recently, the matrices being multiplied
+     * are held by their callers, so they stay alive after the eviction */
+    inline void evictLeastRecentlyUsed() {
+        size_type victim = 0;
+        for (size_type i = 1; i < _squares.size(); i++) {
+            if (_squares[i] != nullptr && (victim == 0 || _lastUse[i] < _lastUse[victim])) {
+                victim = i;
+            }
+        }
+        assert(victim != 0);
+        _squares[victim] = nullptr;
+        _memory -= squareMemory();
+    }
+
+    // _squares[i] is A^(2^i) or nullptr, and _lastUse[i] is the clock of its last use
+    std::vector<std::shared_ptr<const Matrix<T>>> _squares;
+    std::vector<size_type> _lastUse;
+    size_type _clock  = 0;
+    size_type _memory = 0;
+    size_type _budget;
+};
+}  // namespace mca
+
+#endif
@@ -1,35 +1,59 @@
 #include "mca/mca_config.h"
 
-#include <algorithm>
-
 #include "mca/__mca_internal/thread_pool.h"
+#include "mca/execution_context.h"
 
 namespace mca {
 
-ThreadPool &_threadPool = ThreadPool::getInstance();
+void init(const size_t &threadNum,
+          const size_t &limit,
+          const double &eps,
+          const bool &calibration) {
+    ExecutionContext &context = currentContext();
+    context.setThreadNum(threadNum);
+    context.setLimit(limit);
+    context.setEpsilon(eps);
+    if (calibration) { context.calibrate(); }
+}
 
-size_t _limit = 623;
+void setThreadNum(const size_t &threadNum) { currentContext().setThreadNum(threadNum); }
 
-double _eps = 1e-100;
+void setLimit(const size_t &limit) { currentContext().setLimit(limit); }
 
-void init(const size_t &threadNum, const size_t &limit, const double &eps) {
-    _threadPool.resize(threadNum);
-    _limit = limit;
-    _eps   = eps;
+void setGrain(const Operation &op, const size_t &elementSize, const size_t &grain) {
+    currentContext().setGrain(op, elementSize, grain);
 }
 
-void setThreadNum(const size_t &threadNum) { _threadPool.resize(threadNum); }
+void calibrate() { currentContext().calibrate(); }
+
+bool saveGrainTable(const std::string &path) { return currentContext().saveGrainTable(path); }
 
-void setLimit(const size_t &limit) { _limit = std::max<size_t>(1, limit); }
+bool loadGrainTable(const std::string &path) { return currentContext().loadGrainTable(path); }
+
+void setEpsilon(const double &eps) { currentContext().setEpsilon(eps); }
+
+void setStrassenCrossover(const size_t &crossover) {
+    currentContext().setStrassenCrossover(crossover);
+}
 
-void setEpsilon(const double &eps) { _eps = eps; }
+void setStrassenFloatingPoint(const bool &enabled) {
+    currentContext().setStrassenFloatingPoint(enabled);
+}
+
+size_t threadNum() { return currentContext().threadNum(); }
+
+size_t limit() { return currentContext().limit(); }
+
+size_t grain(const Operation &op, const size_t &elementSize) {
+    return currentContext().grain(op, elementSize);
+}
 
-size_t threadNum() { return _threadPool.size(); }
+double epsilon() { return currentContext().epsilon(); }
 
-size_t limit() { return _limit; }
+size_t strassenCrossover() { return currentContext().strassenCrossover(); }
 
-double epsilon() { return _eps; }
+bool strassenFloatingPoint() { return currentContext().strassenFloatingPoint(); }
 
-ThreadPool &threadPool() { return _threadPool; }
+ThreadPool &threadPool() { return currentContext().threadPool(); }
 
 }  // namespace mca
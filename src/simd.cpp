@@ -0,0 +1,26 @@
+#include "simd.h"
+
+namespace mca {
+namespace {
+#ifdef MCA_SIMD
+InstructionSet detectInstructionSet() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) { return InstructionSet::SSE2; }
+    return InstructionSet::SCALAR;
+}
+#else
+InstructionSet detectInstructionSet() { return InstructionSet::SCALAR; }
+#endif
+}  // namespace
+
+InstructionSet instructionSet() {
+    static const InstructionSet detected = detectInstructionSet();
+    return detected;
+}
+}  // namespace mca
@@ -0,0 +1,28 @@
+#ifndef MCA_SIMD_H
+#define MCA_SIMD_H
+
+/* The instruction sets of the SIMD kernels in src, this header is not installed
+ * MCA_SIMD is defined when the compiler can build the x86 kernels,
+ * every kernel is built for its instruction set with the MCA_TARGET_* attributes,
+ * and it is chosen at runtime by instructionSet() */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MCA_SIMD
+#include <immintrin.h>
+
+#define MCA_TARGET_SSE2 __attribute__((target("sse2")))
+#define MCA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MCA_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+/* the loops over the registers must be unrolled, so that the values stay in the registers */
+#define MCA_UNROLL _Pragma("GCC unroll 16")
+#endif
+
+namespace mca {
+/* the instruction sets which have kernels, from the oldest to the newest */
+enum class InstructionSet { SCALAR, SSE2, AVX2, AVX512 };
+
+/* The newest instruction set which both the running CPU and the compiler support
+ * it is detected once when it is used for the first time */
+InstructionSet instructionSet();
+}  // namespace mca
+
+#endif
@@ -0,0 +1,504 @@
+#ifndef MCA_SIMD_VECTOR_H
+#define MCA_SIMD_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.h"
+
+#ifdef MCA_SIMD
+namespace mca {
+/* The vectors of the instruction sets, upon which the kernels in src are written once
+ * every struct calculates Type in Vector of LANES elements, and defines
+ * zero(), load(), store(), storeAligned(), broadcast(), add() and subtract(),
+ * multiply() if MULTIPLY, divide() if DIVIDE, and fma(a, b, c) = a * b + c for the GEMM kernels
+ * the comparisons greater() and greaterEqual() set the lanes of a Mask, which are combined by
+ * maskOr() and tested by any(), the floating points are never ordered with NaN, and they also
+ * define abs(), while the integers define equal(), notEqual() and flipSign(), which flips the
+ * sign bits, so that the unsigned integers are ordered by the signed comparisons
+ * the vectors of double also load float and int32_t, which are converted exactly
+ * the integers wrap around, and the unsigned ones share them */
+struct Sse2Double {
+    using Type                         = double;
+    using Vector                       = __m128d;
+    static constexpr std::size_t LANES = 2;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_SSE2 static inline Vector zero() { return _mm_setzero_pd(); }
+    MCA_TARGET_SSE2 static inline Vector load(const double *p) { return _mm_loadu_pd(p); }
+    MCA_TARGET_SSE2 static inline Vector load(const float *p) {
+        const __m128i low = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+        return _mm_cvtps_pd(_mm_castsi128_ps(low));
+    }
+    MCA_TARGET_SSE2 static inline Vector load(const std::int32_t *p) {
+        return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)));
+    }
+    MCA_TARGET_SSE2 static inline void store(double *p, Vector v) { _mm_storeu_pd(p, v); }
+    MCA_TARGET_SSE2 static inline void storeAligned(double *p, Vector v) { _mm_store_pd(p, v); }
+    MCA_TARGET_SSE2 static inline Vector broadcast(const double *p) { return _mm_set1_pd(*p); }
+    MCA_TARGET_SSE2 static inline Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+    MCA_TARGET_SSE2 static inline Vector subtract(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+    MCA_TARGET_SSE2 static inline Vector multiply(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+    MCA_TARGET_SSE2 static inline Vector divide(Vector a, Vector b) { return _mm_div_pd(a, b); }
+    MCA_TARGET_SSE2 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+    }
+    using Mask = __m128d;
+    MCA_TARGET_SSE2 static inline Mask noMask() { return _mm_setzero_pd(); }
+    MCA_TARGET_SSE2 static inline Mask greater(Vector a, Vector b) { return _mm_cmpgt_pd(a, b); }
+    MCA_TARGET_SSE2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm_cmpge_pd(a, b);
+    }
+    MCA_TARGET_SSE2 static inline Mask maskOr(Mask a, Mask b) { return _mm_or_pd(a, b); }
+    MCA_TARGET_SSE2 static inline bool any(Mask m) { return _mm_movemask_pd(m) != 0; }
+    MCA_TARGET_SSE2 static inline Vector abs(Vector a) {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+    }
+};
+
+struct Sse2Float {
+    using Type                         = float;
+    using Vector                       = __m128;
+    static constexpr std::size_t LANES = 4;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_SSE2 static inline Vector zero() { return _mm_setzero_ps(); }
+    MCA_TARGET_SSE2 static inline Vector load(const float *p) { return _mm_loadu_ps(p); }
+    MCA_TARGET_SSE2 static inline void store(float *p, Vector v) { _mm_storeu_ps(p, v); }
+    MCA_TARGET_SSE2 static inline void storeAligned(float *p, Vector v) { _mm_store_ps(p, v); }
+    MCA_TARGET_SSE2 static inline Vector broadcast(const float *p) { return _mm_set1_ps(*p); }
+    MCA_TARGET_SSE2 static inline Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    MCA_TARGET_SSE2 static inline Vector subtract(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    MCA_TARGET_SSE2 static inline Vector multiply(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    MCA_TARGET_SSE2 static inline Vector divide(Vector a, Vector b) { return _mm_div_ps(a, b); }
+    MCA_TARGET_SSE2 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    using Mask = __m128;
+    MCA_TARGET_SSE2 static inline Mask noMask() { return _mm_setzero_ps(); }
+    MCA_TARGET_SSE2 static inline Mask greater(Vector a, Vector b) { return _mm_cmpgt_ps(a, b); }
+    MCA_TARGET_SSE2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm_cmpge_ps(a, b);
+    }
+    MCA_TARGET_SSE2 static inline Mask maskOr(Mask a, Mask b) { return _mm_or_ps(a, b); }
+    MCA_TARGET_SSE2 static inline bool any(Mask m) { return _mm_movemask_ps(m) != 0; }
+    MCA_TARGET_SSE2 static inline Vector abs(Vector a) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+};
+
+// SSE2 has no multiplication of packed 32-bit integers
+struct Sse2Int32 {
+    using Type                         = std::int32_t;
+    using Vector                       = __m128i;
+    static constexpr std::size_t LANES = 4;
+    static constexpr bool MULTIPLY     = false;
+    static constexpr bool DIVIDE       = false;
+    MCA_TARGET_SSE2 static inline Vector zero() { return _mm_setzero_si128(); }
+    MCA_TARGET_SSE2 static inline Vector load(const std::int32_t *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    MCA_TARGET_SSE2 static inline void store(std::int32_t *p, Vector v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+    MCA_TARGET_SSE2 static inline void storeAligned(std::int32_t *p, Vector v) {
+        _mm_store_si128(reinterpret_cast<__m128i *>(p), v);
+    }
+    MCA_TARGET_SSE2 static inline Vector broadcast(const std::int32_t *p) {
+        return _mm_set1_epi32(*p);
+    }
+    MCA_TARGET_SSE2 static inline Vector add(Vector a, Vector b) { return _mm_add_epi32(a, b); }
+    MCA_TARGET_SSE2 static inline Vector subtract(Vector a, Vector b) {
+        return _mm_sub_epi32(a, b);
+    }
+    using Mask = __m128i;
+    MCA_TARGET_SSE2 static inline Mask noMask() { return _mm_setzero_si128(); }
+    MCA_TARGET_SSE2 static inline Mask greater(Vector a, Vector b) { return _mm_cmpgt_epi32(a, b); }
+    MCA_TARGET_SSE2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm_xor_si128(_mm_cmpgt_epi32(b, a), _mm_set1_epi32(-1));
+    }
+    MCA_TARGET_SSE2 static inline Mask equal(Vector a, Vector b) { return _mm_cmpeq_epi32(a, b); }
+    MCA_TARGET_SSE2 static inline Mask notEqual(Vector a, Vector b) {
+        return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+    }
+    MCA_TARGET_SSE2 static inline Mask maskOr(Mask a, Mask b) { return _mm_or_si128(a, b); }
+    MCA_TARGET_SSE2 static inline bool any(Mask m) { return _mm_movemask_epi8(m) != 0; }
+    MCA_TARGET_SSE2 static inline Vector flipSign(Vector a) {
+        return _mm_xor_si128(a, _mm_set1_epi32(INT32_MIN));
+    }
+};
+
+struct Avx2Double {
+    using Type                         = double;
+    using Vector                       = __m256d;
+    static constexpr std::size_t LANES = 4;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_AVX2 static inline Vector zero() { return _mm256_setzero_pd(); }
+    MCA_TARGET_AVX2 static inline Vector load(const double *p) { return _mm256_loadu_pd(p); }
+    MCA_TARGET_AVX2 static inline Vector load(const float *p) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));
+    }
+    MCA_TARGET_AVX2 static inline Vector load(const std::int32_t *p) {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    }
+    MCA_TARGET_AVX2 static inline void store(double *p, Vector v) { _mm256_storeu_pd(p, v); }
+    MCA_TARGET_AVX2 static inline void storeAligned(double *p, Vector v) {
+        _mm256_store_pd(p, v);
+    }
+    MCA_TARGET_AVX2 static inline Vector broadcast(const double *p) {
+        return _mm256_broadcast_sd(p);
+    }
+    MCA_TARGET_AVX2 static inline Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+    MCA_TARGET_AVX2 static inline Vector subtract(Vector a, Vector b) {
+        return _mm256_sub_pd(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector multiply(Vector a, Vector b) {
+        return _mm256_mul_pd(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector divide(Vector a, Vector b) { return _mm256_div_pd(a, b); }
+    MCA_TARGET_AVX2 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+    using Mask = Vector;
+    MCA_TARGET_AVX2 static inline Mask noMask() { return _mm256_setzero_pd(); }
+    MCA_TARGET_AVX2 static inline Mask greater(Vector a, Vector b) {
+        return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+    }
+    MCA_TARGET_AVX2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+    }
+    MCA_TARGET_AVX2 static inline Mask maskOr(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    MCA_TARGET_AVX2 static inline bool any(Mask m) { return _mm256_movemask_pd(m) != 0; }
+    MCA_TARGET_AVX2 static inline Vector abs(Vector a) {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+    }
+};
+
+struct Avx2Float {
+    using Type                         = float;
+    using Vector                       = __m256;
+    static constexpr std::size_t LANES = 8;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_AVX2 static inline Vector zero() { return _mm256_setzero_ps(); }
+    MCA_TARGET_AVX2 static inline Vector load(const float *p) { return _mm256_loadu_ps(p); }
+    MCA_TARGET_AVX2 static inline void store(float *p, Vector v) { _mm256_storeu_ps(p, v); }
+    MCA_TARGET_AVX2 static inline void storeAligned(float *p, Vector v) { _mm256_store_ps(p, v); }
+    MCA_TARGET_AVX2 static inline Vector broadcast(const float *p) {
+        return _mm256_broadcast_ss(p);
+    }
+    MCA_TARGET_AVX2 static inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    MCA_TARGET_AVX2 static inline Vector subtract(Vector a, Vector b) {
+        return _mm256_sub_ps(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector multiply(Vector a, Vector b) {
+        return _mm256_mul_ps(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector divide(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+    MCA_TARGET_AVX2 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    using Mask = Vector;
+    MCA_TARGET_AVX2 static inline Mask noMask() { return _mm256_setzero_ps(); }
+    MCA_TARGET_AVX2 static inline Mask greater(Vector a, Vector b) {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+    MCA_TARGET_AVX2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+    }
+    MCA_TARGET_AVX2 static inline Mask maskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    MCA_TARGET_AVX2 static inline bool any(Mask m) { return _mm256_movemask_ps(m) != 0; }
+    MCA_TARGET_AVX2 static inline Vector abs(Vector a) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+};
+
+struct Avx2Int32 {
+    using Type                         = std::int32_t;
+    using Vector                       = __m256i;
+    static constexpr std::size_t LANES = 8;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = false;
+    MCA_TARGET_AVX2 static inline Vector zero() { return _mm256_setzero_si256(); }
+    MCA_TARGET_AVX2 static inline Vector load(const std::int32_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    MCA_TARGET_AVX2 static inline void store(std::int32_t *p, Vector v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    MCA_TARGET_AVX2 static inline void storeAligned(std::int32_t *p, Vector v) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    MCA_TARGET_AVX2 static inline Vector broadcast(const std::int32_t *p) {
+        return _mm256_set1_epi32(*p);
+    }
+    MCA_TARGET_AVX2 static inline Vector add(Vector a, Vector b) { return _mm256_add_epi32(a, b); }
+    MCA_TARGET_AVX2 static inline Vector subtract(Vector a, Vector b) {
+        return _mm256_sub_epi32(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector multiply(Vector a, Vector b) {
+        return _mm256_mullo_epi32(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c);
+    }
+    using Mask = __m256i;
+    MCA_TARGET_AVX2 static inline Mask noMask() { return _mm256_setzero_si256(); }
+    MCA_TARGET_AVX2 static inline Mask greater(Vector a, Vector b) {
+        return _mm256_cmpgt_epi32(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm256_xor_si256(_mm256_cmpgt_epi32(b, a), _mm256_set1_epi32(-1));
+    }
+    MCA_TARGET_AVX2 static inline Mask equal(Vector a, Vector b) {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Mask notEqual(Vector a, Vector b) {
+        return _mm256_xor_si256(_mm256_cmpeq_epi32(a, b), _mm256_set1_epi32(-1));
+    }
+    MCA_TARGET_AVX2 static inline Mask maskOr(Mask a, Mask b) { return _mm256_or_si256(a, b); }
+    MCA_TARGET_AVX2 static inline bool any(Mask m) { return !_mm256_testz_si256(m, m); }
+    MCA_TARGET_AVX2 static inline Vector flipSign(Vector a) {
+        return _mm256_xor_si256(a, _mm256_set1_epi32(INT32_MIN));
+    }
+};
+
+// only AVX-512 has the multiplication of packed 64-bit integers
+struct Avx2Int64 {
+    using Type                         = std::int64_t;
+    using Vector                       = __m256i;
+    static constexpr std::size_t LANES = 4;
+    static constexpr bool MULTIPLY     = false;
+    static constexpr bool DIVIDE       = false;
+    MCA_TARGET_AVX2 static inline Vector zero() { return _mm256_setzero_si256(); }
+    MCA_TARGET_AVX2 static inline Vector load(const std::int64_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    MCA_TARGET_AVX2 static inline void store(std::int64_t *p, Vector v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    MCA_TARGET_AVX2 static inline void storeAligned(std::int64_t *p, Vector v) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    MCA_TARGET_AVX2 static inline Vector broadcast(const std::int64_t *p) {
+        return _mm256_set1_epi64x(*p);
+    }
+    MCA_TARGET_AVX2 static inline Vector add(Vector a, Vector b) { return _mm256_add_epi64(a, b); }
+    MCA_TARGET_AVX2 static inline Vector subtract(Vector a, Vector b) {
+        return _mm256_sub_epi64(a, b);
+    }
+    using Mask = __m256i;
+    MCA_TARGET_AVX2 static inline Mask noMask() { return _mm256_setzero_si256(); }
+    MCA_TARGET_AVX2 static inline Mask greater(Vector a, Vector b) {
+        return _mm256_cmpgt_epi64(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm256_xor_si256(_mm256_cmpgt_epi64(b, a), _mm256_set1_epi32(-1));
+    }
+    MCA_TARGET_AVX2 static inline Mask equal(Vector a, Vector b) {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+    MCA_TARGET_AVX2 static inline Mask notEqual(Vector a, Vector b) {
+        return _mm256_xor_si256(_mm256_cmpeq_epi64(a, b), _mm256_set1_epi32(-1));
+    }
+    MCA_TARGET_AVX2 static inline Mask maskOr(Mask a, Mask b) { return _mm256_or_si256(a, b); }
+    MCA_TARGET_AVX2 static inline bool any(Mask m) { return !_mm256_testz_si256(m, m); }
+    MCA_TARGET_AVX2 static inline Vector flipSign(Vector a) {
+        return _mm256_xor_si256(a, _mm256_set1_epi64x(INT64_MIN));
+    }
+};
+
+struct Avx512Double {
+    using Type                         = double;
+    using Vector                       = __m512d;
+    static constexpr std::size_t LANES = 8;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_AVX512 static inline Vector zero() { return _mm512_setzero_pd(); }
+    MCA_TARGET_AVX512 static inline Vector load(const double *p) { return _mm512_loadu_pd(p); }
+    MCA_TARGET_AVX512 static inline Vector load(const float *p) {
+        return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+    }
+    MCA_TARGET_AVX512 static inline Vector load(const std::int32_t *p) {
+        return _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+    }
+    MCA_TARGET_AVX512 static inline void store(double *p, Vector v) { _mm512_storeu_pd(p, v); }
+    MCA_TARGET_AVX512 static inline void storeAligned(double *p, Vector v) {
+        _mm512_store_pd(p, v);
+    }
+    MCA_TARGET_AVX512 static inline Vector broadcast(const double *p) {
+        return _mm512_set1_pd(*p);
+    }
+    MCA_TARGET_AVX512 static inline Vector add(Vector a, Vector b) { return _mm512_add_pd(a, b); }
+    MCA_TARGET_AVX512 static inline Vector subtract(Vector a, Vector b) {
+        return _mm512_sub_pd(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector multiply(Vector a, Vector b) {
+        return _mm512_mul_pd(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector divide(Vector a, Vector b) {
+        return _mm512_div_pd(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+    using Mask = __mmask8;
+    MCA_TARGET_AVX512 static inline Mask noMask() { return 0; }
+    MCA_TARGET_AVX512 static inline Mask greater(Vector a, Vector b) {
+        return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+    }
+    MCA_TARGET_AVX512 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ);
+    }
+    MCA_TARGET_AVX512 static inline Mask maskOr(Mask a, Mask b) { return a | b; }
+    MCA_TARGET_AVX512 static inline bool any(Mask m) { return m != 0; }
+    MCA_TARGET_AVX512 static inline Vector abs(Vector a) { return _mm512_abs_pd(a); }
+};
+
+struct Avx512Float {
+    using Type                         = float;
+    using Vector                       = __m512;
+    static constexpr std::size_t LANES = 16;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = true;
+    MCA_TARGET_AVX512 static inline Vector zero() { return _mm512_setzero_ps(); }
+    MCA_TARGET_AVX512 static inline Vector load(const float *p) { return _mm512_loadu_ps(p); }
+    MCA_TARGET_AVX512 static inline void store(float *p, Vector v) { _mm512_storeu_ps(p, v); }
+    MCA_TARGET_AVX512 static inline void storeAligned(float *p, Vector v) {
+        _mm512_store_ps(p, v);
+    }
+    MCA_TARGET_AVX512 static inline Vector broadcast(const float *p) { return _mm512_set1_ps(*p); }
+    MCA_TARGET_AVX512 static inline Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+    MCA_TARGET_AVX512 static inline Vector subtract(Vector a, Vector b) {
+        return _mm512_sub_ps(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector multiply(Vector a, Vector b) {
+        return _mm512_mul_ps(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector divide(Vector a, Vector b) {
+        return _mm512_div_ps(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    using Mask = __mmask16;
+    MCA_TARGET_AVX512 static inline Mask noMask() { return 0; }
+    MCA_TARGET_AVX512 static inline Mask greater(Vector a, Vector b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+    }
+    MCA_TARGET_AVX512 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ);
+    }
+    MCA_TARGET_AVX512 static inline Mask maskOr(Mask a, Mask b) { return a | b; }
+    MCA_TARGET_AVX512 static inline bool any(Mask m) { return m != 0; }
+    MCA_TARGET_AVX512 static inline Vector abs(Vector a) { return _mm512_abs_ps(a); }
+};
+
+struct Avx512Int32 {
+    using Type                         = std::int32_t;
+    using Vector                       = __m512i;
+    static constexpr std::size_t LANES = 16;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = false;
+    MCA_TARGET_AVX512 static inline Vector zero() { return _mm512_setzero_si512(); }
+    MCA_TARGET_AVX512 static inline Vector load(const std::int32_t *p) {
+        return _mm512_loadu_si512(p);
+    }
+    MCA_TARGET_AVX512 static inline void store(std::int32_t *p, Vector v) {
+        _mm512_storeu_si512(p, v);
+    }
+    MCA_TARGET_AVX512 static inline void storeAligned(std::int32_t *p, Vector v) {
+        _mm512_store_si512(p, v);
+    }
+    MCA_TARGET_AVX512 static inline Vector broadcast(const std::int32_t *p) {
+        return _mm512_set1_epi32(*p);
+    }
+    MCA_TARGET_AVX512 static inline Vector add(Vector a, Vector b) {
+        return _mm512_add_epi32(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector subtract(Vector a, Vector b) {
+        return _mm512_sub_epi32(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector multiply(Vector a, Vector b) {
+        return _mm512_mullo_epi32(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c);
+    }
+    using Mask = __mmask16;
+    MCA_TARGET_AVX512 static inline Mask noMask() { return 0; }
+    MCA_TARGET_AVX512 static inline Mask greater(Vector a, Vector b) {
+        return _mm512_cmpgt_epi32_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm512_cmpge_epi32_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask equal(Vector a, Vector b) {
+        return _mm512_cmpeq_epi32_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask notEqual(Vector a, Vector b) {
+        return _mm512_cmpneq_epi32_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask maskOr(Mask a, Mask b) { return a | b; }
+    MCA_TARGET_AVX512 static inline bool any(Mask m) { return m != 0; }
+    MCA_TARGET_AVX512 static inline Vector flipSign(Vector a) {
+        return _mm512_xor_si512(a, _mm512_set1_epi32(INT32_MIN));
+    }
+};
+
+struct Avx512Int64 {
+    using Type                         = std::int64_t;
+    using Vector                       = __m512i;
+    static constexpr std::size_t LANES = 8;
+    static constexpr bool MULTIPLY     = true;
+    static constexpr bool DIVIDE       = false;
+    MCA_TARGET_AVX512 static inline Vector zero() { return _mm512_setzero_si512(); }
+    MCA_TARGET_AVX512 static inline Vector load(const std::int64_t *p) {
+        return _mm512_loadu_si512(p);
+    }
+    MCA_TARGET_AVX512 static inline void store(std::int64_t *p, Vector v) {
+        _mm512_storeu_si512(p, v);
+    }
+    MCA_TARGET_AVX512 static inline void storeAligned(std::int64_t *p, Vector v) {
+        _mm512_store_si512(p, v);
+    }
+    MCA_TARGET_AVX512 static inline Vector broadcast(const std::int64_t *p) {
+        return _mm512_set1_epi64(*p);
+    }
+    MCA_TARGET_AVX512 static inline Vector add(Vector a, Vector b) {
+        return _mm512_add_epi64(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector subtract(Vector a, Vector b) {
+        return _mm512_sub_epi64(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector multiply(Vector a, Vector b) {
+        return _mm512_mullo_epi64(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Vector fma(Vector a, Vector b, Vector c) {
+        return _mm512_add_epi64(_mm512_mullo_epi64(a, b), c);
+    }
+    using Mask = __mmask8;
+    MCA_TARGET_AVX512 static inline Mask noMask() { return 0; }
+    MCA_TARGET_AVX512 static inline Mask greater(Vector a, Vector b) {
+        return _mm512_cmpgt_epi64_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask greaterEqual(Vector a, Vector b) {
+        return _mm512_cmpge_epi64_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask equal(Vector a, Vector b) {
+        return _mm512_cmpeq_epi64_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask notEqual(Vector a, Vector b) {
+        return _mm512_cmpneq_epi64_mask(a, b);
+    }
+    MCA_TARGET_AVX512 static inline Mask maskOr(Mask a, Mask b) { return a | b; }
+    MCA_TARGET_AVX512 static inline bool any(Mask m) { return m != 0; }
+    MCA_TARGET_AVX512 static inline Vector flipSign(Vector a) {
+        return _mm512_xor_si512(a, _mm512_set1_epi64(INT64_MIN));
+    }
+};
+}  // namespace mca
+#endif
+
+#endif
@@ -1,39 +1,232 @@
 #include "mca/__mca_internal/thread_pool.h"
 
 namespace mca {
+namespace {
+/* the thread pool which the current thread belongs to, and the id of the current thread */
+thread_local ThreadPool *currentPool = nullptr;
+thread_local std::size_t currentId   = 0;
+}  // namespace
+
 void ThreadPool::resize(size_type newSize) {
+    assert(newSize <= MAX_SIZE);
+    if (newSize == 0) {
+        clear();
+        return;
+    }
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    const size_type oldSize = activeNum.load(std::memory_order_relaxed);
     // if the new size is equal to the old one, do nothing
-    if (newSize == size()) { return; }
+    if (newSize == oldSize) { return; }
+
+    if (newSize < oldSize) {
+        // the surplus threads see the flag after their current tasks, their queues are kept
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            for (size_type k = newSize; k < oldSize; k++) {
+                slots[k].load(std::memory_order_relaxed)->retired.store(true,
+                                                                        std::memory_order_relaxed);
+            }
+            activeNum.store(newSize, std::memory_order_release);
+        }
+        sleepCondition.notify_all();
+        return;
+    }
 
-    clear();
     stopped.store(false, std::memory_order_relaxed);
-    assert(taskQueue.size() == 0);
-    taskQueue.reserve(newSize);
-    while (taskQueue.size() < newSize) { taskQueue.emplace_back(); }
-    assert(size() == 0);
-    for (size_type i = 0; i < newSize; i++) {
-        threadQueue.emplace([this, id = size()]() {
-            std::function<void()> task;
-            while (!stopped.load(std::memory_order_relaxed)) {
-                if (taskQueue[id].empty()) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                    continue;
-                }
-                task = taskQueue[id].front();
-                taskQueue[id].pop();
-                task();
+    for (size_type k = oldSize; k < newSize; k++) {
+        Worker *worker = nullptr;
+        if (k < slotNum.load(std::memory_order_relaxed)) {
+            // reuse the slot of a retired thread, whose queue may still hold tasks
+            worker = slots[k].load(std::memory_order_relaxed);
+            if (worker->thread.joinable()) { worker->thread.join(); }
+            worker->retired.store(false, std::memory_order_relaxed);
+        } else {
+            workers.emplace_back(std::make_unique<Worker>());
+            worker = workers.back().get();
+            slots[k].store(worker, std::memory_order_release);
+            slotNum.store(k + 1, std::memory_order_release);
+        }
+        worker->thread = std::thread([this, k]() { work(k); });
+    }
+    activeNum.store(newSize, std::memory_order_release);
+}
+
+void ThreadPool::addTask(Task *task, const size_type &count) {
+    const size_type n = activeNum.load(std::memory_order_acquire);
+    assert(n != 0);
+    for (size_type c = 0; c < count; c++) {
+        size_type shard = i.fetch_add(1, std::memory_order_relaxed) % n;
+        bool pushed     = false;
+        // take the first shard which is not being pushed by other threads
+        // a shard retired meanwhile is fine, its tasks will be stolen by the other threads
+        for (size_type k = 0; k < n && !pushed; k++) {
+            Worker &worker = *slots[(shard + k) % n].load(std::memory_order_acquire);
+            std::unique_lock<std::mutex> lock(worker.pushMutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                worker.tasks.push(task);
+                pushed = true;
             }
-        });
+        }
+        // all the shards are busy, wait for the first one
+        if (!pushed) {
+            Worker &worker = *slots[shard].load(std::memory_order_acquire);
+            std::lock_guard<std::mutex> lock(worker.pushMutex);
+            worker.tasks.push(task);
+        }
+    }
+    // pairs with the fence in work(), either the sleeping thread sees the task,
+    // or we see the sleeping thread
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_type wakeNum = std::min(count, sleeping.load(std::memory_order_relaxed));
+    if (wakeNum > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        for (size_type k = 0; k < wakeNum; k++) { sleepCondition.notify_one(); }
     }
 }
 
 void ThreadPool::clear() {
-    stopped.store(true, std::memory_order_relaxed);
-    while (!threadQueue.empty()) {
-        threadQueue.front().join();
-        threadQueue.pop();
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopped.store(true, std::memory_order_relaxed);
+    }
+    sleepCondition.notify_all();
+    for (auto &worker : workers) {
+        if (worker->thread.joinable()) { worker->thread.join(); }
+    }
+    // remove the tasks which have not been run
+    Task *task = nullptr;
+    for (auto &worker : workers) {
+        while (worker->tasks.pop(task)) { task->discard(); }
+    }
+    for (size_type k = 0; k < workers.size(); k++) {
+        slots[k].store(nullptr, std::memory_order_relaxed);
+    }
+    slotNum.store(0, std::memory_order_relaxed);
+    activeNum.store(0, std::memory_order_relaxed);
+    std::vector<std::unique_ptr<Worker>>().swap(workers);
+    i.store(0, std::memory_order_relaxed);
+}
+
+bool ThreadPool::runPendingTask() {
+    if (currentPool != this) { return false; }
+    Task *task = findTask(currentId);
+    if (task == nullptr) { return false; }
+    task->run();
+    return true;
+}
+
+void ThreadPool::work(const size_type &id) {
+    currentPool   = this;
+    currentId     = id;
+    Worker &self  = *slots[id].load(std::memory_order_acquire);
+    auto finished = [this, &self]() {
+        return stopped.load(std::memory_order_relaxed) ||
+               self.retired.load(std::memory_order_relaxed);
+    };
+    while (!finished()) {
+        Task *task = findTask(id);
+        if (task != nullptr) {
+            task->run();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // sleep until there is a task, or the pool is stopped, or the thread is retired
+        sleepCondition.wait(lock, [this, &finished]() { return finished() || hasTask(); });
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // a retired thread may have been woken for a task, pass the wakeup on
+    if (!stopped.load(std::memory_order_relaxed) && hasTask()) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_one();
+    }
+    currentPool = nullptr;
+}
+
+ThreadPool::Task *ThreadPool::findTask(const size_type &id) {
+    Task *task = nullptr;
+    // a failed steal may be caused by a race with other threads,
+    // so retry while the queues are not empty
+    // the queues of the retired threads are scanned too, so that no task is lost
+    do {
+        const size_type n = slotNum.load(std::memory_order_acquire);
+        for (size_type k = 0; k < n; k++) {
+            if (slots[(id + k) % n].load(std::memory_order_acquire)->tasks.steal(task)) {
+                return task;
+            }
+        }
+    } while (!stopped.load(std::memory_order_relaxed) && hasTask());
+    return nullptr;
+}
+
+void ThreadPool::ForkJoinTask::start(const size_type &taskNum,
+                                     const void *function,
+                                     Invoker invoker,
+                                     const size_type &helperNum) {
+    this->taskNum  = taskNum;
+    this->function = function;
+    this->invoker  = invoker;
+    next.store(0, std::memory_order_relaxed);
+    finished.store(0, std::memory_order_relaxed);
+    references.store(helperNum + 1, std::memory_order_relaxed);
+    exception = nullptr;
+}
+
+void ThreadPool::ForkJoinTask::execute() {
+    size_type k = 0;
+    while ((k = next.fetch_add(1, std::memory_order_relaxed)) < taskNum) {
+        try {
+            invoker(function, k);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception) { exception = std::current_exception(); }
+        }
+        if (finished.fetch_add(1, std::memory_order_acq_rel) + 1 == taskNum) {
+            std::lock_guard<std::mutex> lock(mutex);
+            condition.notify_one();
+        }
+    }
+}
+
+void ThreadPool::ForkJoinTask::join() {
+    if (finished.load(std::memory_order_acquire) != taskNum) {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() {
+            return finished.load(std::memory_order_acquire) == taskNum;
+        });
+    }
+    std::exception_ptr error = std::move(exception);
+    exception                = nullptr;
+    release();
+    if (error) { std::rethrow_exception(error); }
+}
+
+void ThreadPool::ForkJoinTask::release() {
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(pool.forkJoinMutex);
+        pool.freeForkJoinTasks.push_back(this);
+    }
+}
+
+ThreadPool::ForkJoinTask *ThreadPool::acquireForkJoinTask() {
+    std::lock_guard<std::mutex> lock(forkJoinMutex);
+    if (freeForkJoinTasks.empty()) {
+        forkJoinTasks.emplace_back(std::make_unique<ForkJoinTask>(*this));
+        freeForkJoinTasks.reserve(forkJoinTasks.size());
+        return forkJoinTasks.back().get();
+    }
+    ForkJoinTask *task = freeForkJoinTasks.back();
+    freeForkJoinTasks.pop_back();
+    return task;
+}
+
+bool ThreadPool::hasTask() const {
+    const size_type n = slotNum.load(std::memory_order_acquire);
+    for (size_type k = 0; k < n; k++) {
+        if (!slots[k].load(std::memory_order_acquire)->tasks.empty()) { return true; }
     }
-    std::vector<std::queue<std::function<void()>>>().swap(taskQueue);
-    i = 0;
+    return false;
 }
 }  // namespace mca
@@ -0,0 +1,168 @@
+#include "mca/__mca_internal/transpose.h"
+
+#include "simd.h"
+
+namespace mca {
+namespace {
+#ifdef MCA_SIMD
+/* every kernel transposes an 8 x 8 tile, see TransposeKernel
+ * the elements are loaded as float or double, but they are only shuffled, never calculated,
+ * so that the bits of any other type of the size are kept */
+static_assert(TransposeBlocking<float>::TILE == 8 && TransposeBlocking<double>::TILE == 8);
+
+/* transpose the 4 x 4 tiles of 32-bit elements one by one */
+MCA_TARGET_SSE2 void sse2Transpose32(const void *source,
+                                     const std::size_t &sourceStride,
+                                     void *target,
+                                     const std::size_t &targetStride) {
+    const float *s = static_cast<const float *>(source);
+    float *t       = static_cast<float *>(target);
+    for (std::size_t bi = 0; bi < 8; bi += 4) {
+        for (std::size_t bj = 0; bj < 8; bj += 4) {
+            const float *p = s + bi * sourceStride + bj;
+            __m128 r0      = _mm_loadu_ps(p);
+            __m128 r1      = _mm_loadu_ps(p + sourceStride);
+            __m128 r2      = _mm_loadu_ps(p + 2 * sourceStride);
+            __m128 r3      = _mm_loadu_ps(p + 3 * sourceStride);
+            __m128 t0      = _mm_unpacklo_ps(r0, r1);
+            __m128 t1      = _mm_unpacklo_ps(r2, r3);
+            __m128 t2      = _mm_unpackhi_ps(r0, r1);
+            __m128 t3      = _mm_unpackhi_ps(r2, r3);
+            float *q       = t + bj * targetStride + bi;
+            _mm_storeu_ps(q, _mm_movelh_ps(t0, t1));
+            _mm_storeu_ps(q + targetStride, _mm_movehl_ps(t1, t0));
+            _mm_storeu_ps(q + 2 * targetStride, _mm_movelh_ps(t2, t3));
+            _mm_storeu_ps(q + 3 * targetStride, _mm_movehl_ps(t3, t2));
+        }
+    }
+}
+
+/* transpose the 2 x 2 tiles of 64-bit elements one by one */
+MCA_TARGET_SSE2 void sse2Transpose64(const void *source,
+                                     const std::size_t &sourceStride,
+                                     void *target,
+                                     const std::size_t &targetStride) {
+    const double *s = static_cast<const double *>(source);
+    double *t       = static_cast<double *>(target);
+    MCA_UNROLL
+    for (std::size_t bi = 0; bi < 8; bi += 2) {
+        MCA_UNROLL
+        for (std::size_t bj = 0; bj < 8; bj += 2) {
+            __m128d r0 = _mm_loadu_pd(s + bi * sourceStride + bj);
+            __m128d r1 = _mm_loadu_pd(s + (bi + 1) * sourceStride + bj);
+            _mm_storeu_pd(t + bj * targetStride + bi, _mm_unpacklo_pd(r0, r1));
+            _mm_storeu_pd(t + (bj + 1) * targetStride + bi, _mm_unpackhi_pd(r0, r1));
+        }
+    }
+}
+
+/* transpose the 8 x 8 tile of 32-bit elements in 8 registers:
+ * the pairs of the rows are interleaved, then the pairs of the pairs,
+ * and the 128-bit halves are exchanged at last */
+MCA_TARGET_AVX2 void avx2Transpose32(const void *source,
+                                     const std::size_t &sourceStride,
+                                     void *target,
+                                     const std::size_t &targetStride) {
+    const float *s = static_cast<const float *>(source);
+    float *t       = static_cast<float *>(target);
+    __m256 r[8], u[8];
+    MCA_UNROLL
+    for (std::size_t i = 0; i < 8; i++) { r[i] = _mm256_loadu_ps(s + i * sourceStride); }
+    MCA_UNROLL
+    for (std::size_t i = 0; i < 8; i += 4) {
+        __m256 t0 = _mm256_unpacklo_ps(r[i], r[i + 1]);
+        __m256 t1 = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        __m256 t2 = _mm256_unpacklo_ps(r[i + 2], r[i + 3]);
+        __m256 t3 = _mm256_unpackhi_ps(r[i + 2], r[i + 3]);
+        u[i]      = _mm256_shuffle_ps(t0, t2, 0x44);
+        u[i + 1]  = _mm256_shuffle_ps(t0, t2, 0xEE);
+        u[i + 2]  = _mm256_shuffle_ps(t1, t3, 0x44);
+        u[i + 3]  = _mm256_shuffle_ps(t1, t3, 0xEE);
+    }
+    MCA_UNROLL
+    for (std::size_t j = 0; j < 4; j++) {
+        _mm256_storeu_ps(t + j * targetStride, _mm256_permute2f128_ps(u[j], u[j + 4], 0x20));
+        _mm256_storeu_ps(t + (j + 4) * targetStride,
+                         _mm256_permute2f128_ps(u[j], u[j + 4], 0x31));
+    }
+}
+
+/* transpose the 4 x 4 tiles of 64-bit elements one by one */
+MCA_TARGET_AVX2 void avx2Transpose64(const void *source,
+                                     const std::size_t &sourceStride,
+                                     void *target,
+                                     const std::size_t &targetStride) {
+    const double *s = static_cast<const double *>(source);
+    double *t       = static_cast<double *>(target);
+    MCA_UNROLL
+    for (std::size_t bi = 0; bi < 8; bi += 4) {
+        MCA_UNROLL
+        for (std::size_t bj = 0; bj < 8; bj += 4) {
+            const double *p = s + bi * sourceStride + bj;
+            __m256d r0      = _mm256_loadu_pd(p);
+            __m256d r1      = _mm256_loadu_pd(p + sourceStride);
+            __m256d r2      = _mm256_loadu_pd(p + 2 * sourceStride);
+            __m256d r3      = _mm256_loadu_pd(p + 3 * sourceStride);
+            __m256d t0      = _mm256_unpacklo_pd(r0, r1);
+            __m256d t1      = _mm256_unpackhi_pd(r0, r1);
+            __m256d t2      = _mm256_unpacklo_pd(r2, r3);
+            __m256d t3      = _mm256_unpackhi_pd(r2, r3);
+            double *q       = t + bj * targetStride + bi;
+            _mm256_storeu_pd(q, _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd(q + targetStride, _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd(q + 2 * targetStride, _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd(q + 3 * targetStride, _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+    }
+}
+
+/* transpose the 8 x 8 tile of 64-bit elements in 8 registers:
+ * the pairs of the rows are interleaved, then the 128-bit lanes are gathered twice */
+MCA_TARGET_AVX512 void avx512Transpose64(const void *source,
+                                         const std::size_t &sourceStride,
+                                         void *target,
+                                         const std::size_t &targetStride) {
+    const double *s = static_cast<const double *>(source);
+    double *t       = static_cast<double *>(target);
+    __m512d r[8], u[8];
+    MCA_UNROLL
+    for (std::size_t i = 0; i < 8; i++) { r[i] = _mm512_loadu_pd(s + i * sourceStride); }
+    MCA_UNROLL
+    for (std::size_t i = 0; i < 8; i += 4) {
+        __m512d t0 = _mm512_unpacklo_pd(r[i], r[i + 1]);
+        __m512d t1 = _mm512_unpackhi_pd(r[i], r[i + 1]);
+        __m512d t2 = _mm512_unpacklo_pd(r[i + 2], r[i + 3]);
+        __m512d t3 = _mm512_unpackhi_pd(r[i + 2], r[i + 3]);
+        u[i]       = _mm512_shuffle_f64x2(t0, t2, 0x88);
+        u[i + 1]   = _mm512_shuffle_f64x2(t1, t3, 0x88);
+        u[i + 2]   = _mm512_shuffle_f64x2(t0, t2, 0xDD);
+        u[i + 3]   = _mm512_shuffle_f64x2(t1, t3, 0xDD);
+    }
+    MCA_UNROLL
+    for (std::size_t j = 0; j < 4; j++) {
+        _mm512_storeu_pd(t + j * targetStride, _mm512_shuffle_f64x2(u[j], u[j + 4], 0x88));
+        _mm512_storeu_pd(t + (j + 4) * targetStride, _mm512_shuffle_f64x2(u[j], u[j + 4], 0xDD));
+    }
+}
+#endif
+}  // namespace
+
+// a tile of 32-bit elements is a single pass of AVX2, so AVX-512 shares it
+TransposeKernel transposeSimdKernel(const std::size_t &elementSize) {
+#ifdef MCA_SIMD
+    const InstructionSet set = instructionSet();
+    if (elementSize == 4) {
+        if (set >= InstructionSet::AVX2) { return avx2Transpose32; }
+        if (set == InstructionSet::SSE2) { return sse2Transpose32; }
+    } else if (elementSize == 8) {
+        switch (set) {
+            case InstructionSet::AVX512: return avx512Transpose64;
+            case InstructionSet::AVX2: return avx2Transpose64;
+            case InstructionSet::SSE2: return sse2Transpose64;
+            default: break;
+        }
+    }
+#endif
+    return nullptr;
+}
+}  // namespace mca
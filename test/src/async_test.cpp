@@ -0,0 +1,135 @@
+#include "mca/async.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+#include "mca/matrix.h"
+#include "mca/mca.h"
+
+namespace mca {
+namespace test {
+class TestAsync : public testing::Test {
+protected:
+    static constexpr size_t THREAD_NUM = 4;
+
+    void SetUp() override {
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = static_cast<double>(i % 7);
+            b[i] = static_cast<double>(i % 5);
+            c[i] = static_cast<double>(i % 3);
+            d[i] = static_cast<double>(i % 11);
+        }
+    }
+
+    void TearDown() override { init(0); }
+
+    Matrix<double> a{Shape(60, 60)}, b{Shape(60, 60)}, c{Shape(60, 60)}, d{Shape(60, 60)};
+};
+
+TEST_F(TestAsync, operations) {
+    Matrix<double> sum = a + b, difference = a - b, product = a * b, quotient = a / 2.;
+    Matrix<double> transposed = a.transpose(), power(a.shape());
+    pow(a, 3, power);
+
+    init(THREAD_NUM);
+
+    auto sumFuture        = async::add(a, b);
+    auto differenceFuture = async::subtract(a, b);
+    auto productFuture    = async::multiply(a, b);
+    auto quotientFuture   = async::divide(a, 2.);
+    auto transposeFuture  = async::transpose(a);
+    auto powerFuture      = async::pow(a, 3);
+    ASSERT_TRUE(sumFuture.get() == sum);
+    ASSERT_TRUE(differenceFuture.get() == difference);
+    ASSERT_TRUE(productFuture.get() == product);
+    ASSERT_TRUE(quotientFuture.get() == quotient);
+    ASSERT_TRUE(transposeFuture.get() == transposed);
+    ASSERT_TRUE(powerFuture.get() == power);
+    ASSERT_FALSE(sumFuture.valid());
+}
+
+TEST_F(TestAsync, then) {
+    Matrix<double> expected = a * b + c * d;
+
+    init(THREAD_NUM);
+
+    // A * B and C * D are calculated at the same time
+    auto cd     = async::multiply(c, d);
+    auto result = async::multiply(a, b).then([&cd](Matrix<double> &&ab) { return ab + cd.get(); });
+    ASSERT_TRUE(result.get() == expected);
+
+    bool called = false;
+    auto chain  = async::run([]() {}).then([&called]() { called = true; });
+    chain.wait();
+    ASSERT_TRUE(chain.ready());
+    ASSERT_TRUE(called);
+
+    // the continuations may be move-only
+    auto scale = std::make_unique<double>(2.);
+    auto twice = async::multiply(a, b).then(
+        [scale = std::move(scale)](Matrix<double> &&ab) { return ab * *scale; });
+    ASSERT_TRUE(twice.get() == a * b * 2.);
+    auto ready = async::run([]() { return 1; });
+    ready.wait();
+    auto owner = std::make_unique<int>(2);
+    auto sum   = ready.then([owner = std::move(owner)](int value) { return value + *owner; });
+    ASSERT_EQ(sum.get(), 3);
+}
+
+TEST_F(TestAsync, exception) {
+    init(THREAD_NUM);
+    auto future = async::run([]() -> int { throw std::runtime_error("error"); });
+    ASSERT_THROW(future.get(), std::runtime_error);
+    // the exception is passed through the continuations
+    auto chain = async::run([]() -> int { throw std::runtime_error("error"); }).then([](int value) {
+        return value + 1;
+    });
+    ASSERT_THROW(chain.get(), std::runtime_error);
+}
+
+TEST_F(TestAsync, singleThread) {
+    Matrix<double> product = a * b;
+    // the calculation finishes in the calling thread
+    auto future = async::multiply(a, b);
+    ASSERT_TRUE(future.ready());
+    ASSERT_TRUE(future.get() == product);
+}
+
+// a task of the pool waits for another asynchronous calculation
+TEST_F(TestAsync, nested) {
+    Matrix<double> expected = a * b + c;
+
+    init(THREAD_NUM);
+
+    std::vector<async::Future<Matrix<double>>> futures;
+    for (size_t i = 0; i < THREAD_NUM * 2; i++) {
+        futures.emplace_back(async::run([this]() { return async::multiply(a, b).get() + c; }));
+    }
+    for (auto &future : futures) { ASSERT_TRUE(future.get() == expected); }
+}
+
+// this test will record the time of calculating a * b + c * d synchronously and asynchronously
+TEST_F(TestAsync, overlap) {
+    using namespace std::chrono;
+    init(THREAD_NUM);
+
+    auto startTime         = steady_clock::now();
+    Matrix<double> result1 = a * b + c * d;
+    auto syncTime          = steady_clock::now() - startTime;
+
+    startTime              = steady_clock::now();
+    auto cd                = async::multiply(c, d);
+    Matrix<double> result2 = async::multiply(a, b).get() + cd.get();
+    auto asyncTime         = steady_clock::now() - startTime;
+
+    ASSERT_TRUE(result1 == result2);
+    testing::Test::RecordProperty("SyncMicroseconds",
+                                  static_cast<int>(duration_cast<microseconds>(syncTime).count()));
+    testing::Test::RecordProperty("AsyncMicroseconds",
+                                  static_cast<int>(duration_cast<microseconds>(asyncTime).count()));
+}
+}  // namespace test
+}  // namespace mca
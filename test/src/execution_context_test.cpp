@@ -0,0 +1,82 @@
+#include "mca/execution_context.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "mca/matrix.h"
+#include "mca/mca.h"
+
+namespace mca {
+namespace test {
+TEST(TestExecutionContext, constructor) {
+    ExecutionContext context(3, 100, 1e-7);
+    ASSERT_EQ(context.threadNum(), (size_t)3);
+    ASSERT_EQ(context.limit(), (size_t)100);
+    ASSERT_EQ(context.epsilon(), 1e-7);
+    // the default context is not changed
+    ASSERT_EQ(&currentContext(), &defaultContext());
+    ASSERT_EQ(&defaultContext().threadPool(), &ThreadPool::getInstance());
+    // a context can use the threads of another one
+    ExecutionContext shared(context.threadPool(), 10);
+    ASSERT_EQ(shared.threadNum(), (size_t)3);
+    context.setThreadNum(2);
+    ASSERT_EQ(shared.threadNum(), (size_t)2);
+}
+
+TEST(TestExecutionContext, scopedExecutionContext) {
+    ExecutionContext outer(2, 10), inner(3, 20);
+    {
+        ScopedExecutionContext outerScope(outer);
+        ASSERT_EQ(&currentContext(), &outer);
+        ASSERT_EQ(threadNum(), (size_t)2);
+        {
+            ScopedExecutionContext innerScope(inner);
+            ASSERT_EQ(&currentContext(), &inner);
+            ASSERT_EQ(limit(), (size_t)20);
+            // the configurations of the current context are changed
+            setEpsilon(1e-3);
+            ASSERT_EQ(inner.epsilon(), 1e-3);
+        }
+        ASSERT_EQ(&currentContext(), &outer);
+        ASSERT_EQ(threadPool().size(), (size_t)2);
+    }
+    ASSERT_EQ(&currentContext(), &defaultContext());
+    // every thread has its own current context
+    ScopedExecutionContext scope(outer);
+    std::thread([]() { ASSERT_EQ(&currentContext(), &defaultContext()); }).join();
+}
+
+TEST(TestExecutionContext, calculation) {
+    Matrix<double> a(Shape(50, 50)), b(Shape(50, 50));
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<double>(i % 7);
+        b[i] = static_cast<double>(i % 5);
+    }
+    Matrix<double> product = a * b, transposed = a.transpose(), power(a.shape());
+    pow(a, 3, power);
+
+    ExecutionContext context(4, 10);
+    Matrix<double> result = context.run([&]() { return a * b; });
+    ASSERT_TRUE(result == product);
+    Matrix<double> output(Shape(50, 50));
+    transpose(context, a, output);
+    ASSERT_TRUE(output == transposed);
+    pow(context, a, 3, output);
+    ASSERT_TRUE(output == power);
+}
+
+// the chunks which run in the threads of the pool use the epsilon of the calling thread's context
+TEST(TestExecutionContext, epsilon) {
+    Matrix<double> a(Shape(100, 100), 1.), b(Shape(100, 100), 1. + 1e-5);
+    ExecutionContext strict(4, 10, 1e-100), loose(4, 10, 1e-3);
+    bool strictResult = true, looseResult = false;
+    std::thread strictThread([&]() { strictResult = strict.run([&]() { return a == b; }); });
+    std::thread looseThread([&]() { looseResult = loose.run([&]() { return a == b; }); });
+    strictThread.join();
+    looseThread.join();
+    ASSERT_FALSE(strictResult);
+    ASSERT_TRUE(looseResult);
+}
+}  // namespace test
+}  // namespace mca
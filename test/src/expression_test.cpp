@@ -0,0 +1,62 @@
+#include "mca/expression.h"
+
+#include <gtest/gtest.h>
+
+#include "mca/matrix.h"
+#include "mca/mca.h"
+
+namespace mca {
+namespace test {
+class TestExpression : public testing::Test {
+protected:
+    static constexpr size_t THREAD_NUM = 4;
+
+    void SetUp() override {
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = static_cast<double>(i % 7);
+            b[i] = static_cast<double>(i % 5 + 1);
+            c[i] = static_cast<double>(i % 3);
+            n[i] = static_cast<int>(i % 11);
+        }
+    }
+
+    void TearDown() override { init(0); }
+
+    Matrix<double> a{Shape(300, 200)}, b{Shape(300, 200)}, c{Shape(300, 200)};
+    Matrix<int> n{Shape(300, 200)};
+};
+
+TEST_F(TestExpression, sameAsEager) {
+    init(THREAD_NUM);
+    Matrix<double> result = Lazy(a) * 2 + b - c / 3;
+    ASSERT_EQ(result, a * 2 + b - c / 3);
+    result = 1 - (2 + Lazy(a)) / 4 * 0.5 + (Lazy(c) - b);
+    ASSERT_EQ(result, 1 - (2 + a) / 4 * 0.5 + (c - b));
+    // every node is calculated in the common type of its operands
+    Matrix<int> integers = (Lazy(n) + n) / 4 * 2.5;
+    ASSERT_EQ(integers, Matrix<int>((n + n) / 4 * 2.5));
+    Matrix<float> output(a.shape());
+    evaluate(Lazy(n) - a, output);
+    ASSERT_EQ(output, Matrix<float>(n - a));
+}
+
+TEST_F(TestExpression, inPlace) {
+    init(THREAD_NUM);
+    const Matrix<double> expected = a * 3 + a - b;
+    const double *data            = a.data();
+    a                             = Lazy(a) * 3 + a - b;
+    ASSERT_EQ(a.data(), data);
+    ASSERT_EQ(a, expected);
+}
+
+TEST_F(TestExpression, temporaryMatrix) {
+    // the temporary matrices are moved into the expression, so it can be evaluated later
+    auto expression = Lazy(a + b) - Matrix<double>(c) * 2;
+    Matrix<double> result(expression);
+    ASSERT_EQ(result, a + b - c * 2);
+    const Matrix<double> transposed = a.transpose();
+    result                          = Lazy(transposed.transpose()) + b;
+    ASSERT_EQ(result, a + b);
+}
+}  // namespace test
+}  // namespace mca
@@ -2,8 +2,15 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 
+#include "mca/diag.h"
+#include "mca/matrix.h"
+
 namespace mca {
 namespace test {
 TEST(TestConfiguration, init) {
@@ -29,5 +36,68 @@ TEST(TestConfiguration, setEpsilon) {
     setEpsilon(1e-7);
     ASSERT_EQ(epsilon(), 1e-7);
 }
+
+TEST(TestConfiguration, grain) {
+    setLimit(623);
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(double)), 623);
+    ASSERT_GT(grain(Operation::MATRIX_FILL, sizeof(double)), 623);
+    ASSERT_LT(grain(Operation::MATRIX_NUMBER_POW, sizeof(double)), 623);
+    setGrain(Operation::MATRIX_ADDITION, sizeof(double), 10000);
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(double)), 10000);
+    // the elements of the same size share the grain
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(std::int64_t)), 10000);
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(float)), 623);
+    ASSERT_EQ(grain(Operation::MATRIX_SUBTRACTION, sizeof(double)), 623);
+    // setting the limit clears the table
+    setLimit(623);
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(double)), 623);
+}
+
+TEST(TestConfiguration, calibrate) {
+    using namespace std::chrono;
+    setLimit(623);
+    auto startTime = steady_clock::now();
+    calibrate();
+    testing::Test::RecordProperty(
+        "CalibrationMilliseconds",
+        static_cast<int>(duration_cast<milliseconds>(steady_clock::now() - startTime).count()));
+    // std::pow is much slower than copying an element
+    ASSERT_LT(grain(Operation::MATRIX_NUMBER_POW, sizeof(double)),
+              grain(Operation::MATRIX_FILL, sizeof(double)));
+
+    auto path = (std::filesystem::temp_directory_path() / "mca_grain_table.txt").string();
+    ASSERT_TRUE(saveGrainTable(path));
+    std::vector<size_type> grains;
+    for (size_type op = 0; op < OPERATION_NUM; op++) {
+        grains.emplace_back(grain(static_cast<Operation>(op), sizeof(float)));
+    }
+    setLimit(623);
+    ASSERT_TRUE(loadGrainTable(path));
+    for (size_type op = 0; op < OPERATION_NUM; op++) {
+        ASSERT_EQ(grain(static_cast<Operation>(op), sizeof(float)), grains[op]);
+    }
+    // an invalid file will be ignored
+    std::ofstream(path) << "invalid";
+    ASSERT_FALSE(loadGrainTable(path));
+    ASSERT_EQ(grain(Operation::MATRIX_ADDITION, sizeof(float)), grains[0]);
+    std::filesystem::remove(path);
+    ASSERT_FALSE(loadGrainTable(path));
+    init(0);
+}
+
+TEST(TestMca, powDifferentType) {
+    // the power is calculated in double, and cast into int once
+    const Matrix<double> a(Diag({1.5, 1.5}));
+    Matrix<int> output(a.shape());
+    pow(a, 2, output);
+    ASSERT_EQ(output, Matrix<int>(Diag({2, 2})));
+    pow(a, 5, output);
+    ASSERT_EQ(output, Matrix<int>(Diag({7, 7})));
+    // the int matrices are calculated in the double output
+    const Matrix<int> b(Shape{2, 2}, {1, 1, 1, 0});
+    Matrix<double> power(b.shape());
+    pow(b, 10, power);
+    ASSERT_EQ(power, Matrix<double>(Shape{2, 2}, {89, 55, 55, 34}));
+}
 }  // namespace test
 }  // namespace mca
@@ -1,10 +1,13 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <limits>
 #include <random>
 
 #include "mca/__mca_internal/single_thread_matrix_calculation.h"
+#include "mca/execution_context.h"
 #include "mca/matrix.h"
 #include "mca/mca.h"
 
@@ -686,6 +689,53 @@ TEST_F(TestMultiThreadCalculation, transposeMatrixToOutput) {
     ASSERT_EQ(singleOutput, multiOutput);
 }
 
+// the tiles of the threads do not match the blocks, and the tiles cover the matrix
+TEST_F(TestMultiThreadCalculation, tiledTranspose) {
+    init(THREAD_NUM);
+    for (const auto &shape : {Shape{1, 1000}, Shape{1000, 3}, Shape{257, 131}}) {
+        Matrix<float> x(shape), output(Shape{shape.columns, shape.rows});
+        for (auto &element : x) { element = static_cast<float>(generator() % MAX_VALUE); }
+        transpose(x, output);
+        for (size_t i = 0; i < x.rows(); i++) {
+            for (size_t j = 0; j < x.columns(); j++) { ASSERT_EQ(output.get(j, i), x.get(i, j)); }
+        }
+
+        Tiling tiling = transposeTiling<float>(shape.rows, shape.columns, 16);
+        Matrix<int> covered(shape, 0);
+        size_t rowBegin = 0, rowEnd = 0, columnBegin = 0, columnEnd = 0;
+        for (size_t t = 0; t < tiling.tileNum(); t++) {
+            tiling.tile(t, rowBegin, rowEnd, columnBegin, columnEnd);
+            for (size_t i = rowBegin; i < rowEnd; i++) {
+                for (size_t j = columnBegin; j < columnEnd; j++) { covered.get(i, j)++; }
+            }
+        }
+        ASSERT_EQ(covered, Matrix<int>(shape, 1));
+    }
+}
+
+// the square matrices swap the pairs of the blocks, and the others follow the cycles
+template <class T>
+void checkInPlaceTranspose(const Shape &shape) {
+    Matrix<T> x(shape), expected(Shape{shape.columns, shape.rows});
+    for (size_t i = 0; i < x.size(); i++) { x[i] = static_cast<T>(i % 1009); }
+    transpose(x, expected);
+    const T *data = x.data();
+    transpose(x);
+    ASSERT_EQ(x.data(), data);
+    ASSERT_EQ(x, expected);
+}
+
+TEST_F(TestMultiThreadCalculation, inPlaceTranspose) {
+    init(THREAD_NUM);
+    for (const auto &shape : {Shape{0, 0}, Shape{1, 1}, Shape{8, 8}, Shape{131, 131},
+                              Shape{300, 300}, Shape{1, 17}, Shape{17, 1}, Shape{37, 91}}) {
+        checkInPlaceTranspose<std::int8_t>(shape);
+        checkInPlaceTranspose<float>(shape);
+        checkInPlaceTranspose<double>(shape);
+        checkInPlaceTranspose<long double>(shape);
+    }
+}
+
 TEST_F(TestMultiThreadCalculation, pow) {
     auto value = generator() % MAX_VALUE, exponent = generator() % MAX_VALUE;
 
@@ -746,6 +796,174 @@ TEST_F(TestMultiThreadCalculation, powToOutput) {
     ASSERT_EQ(singleOutput, multiOutput);
 }
 
+// the powers are squared from the highest bit, so every exponent must give the repeated product,
+// the integers wrap around in the same way in both
+TEST_F(TestMultiThreadCalculation, powExponents) {
+    init(THREAD_NUM);
+    Matrix<std::int64_t> x(Shape{37, 37});
+    for (size_t i = 0; i < x.size(); i++) { x[i] = static_cast<std::int64_t>(i % 7) - 3; }
+    Matrix<std::int64_t> expected(x.shape(), IdentityMatrix()), output(x.shape());
+    for (size_t exponent = 0; exponent <= 13; exponent++) {
+        pow(x, exponent, output);
+        ASSERT_EQ(output, expected);
+        expected = expected * x;
+    }
+    // the output may be the matrix itself, or of another type
+    Matrix<std::int64_t> same(x);
+    pow(same, 6, same);
+    Matrix<double> converted(x.shape());
+    pow(x, 6, converted);
+    pow(x, 6, output);
+    ASSERT_EQ(same, output);
+    ASSERT_EQ(converted, Matrix<double>(output));
+}
+
+TEST_F(TestMultiThreadCalculation, powModExponents) {
+    init(THREAD_NUM);
+    // the naive product of the residues, which is reduced for every element
+    auto multiplyMod = [](const Matrix<std::uint64_t> &x,
+                          const Matrix<std::uint64_t> &y,
+                          const std::uint64_t &modulus) {
+        Matrix<std::uint64_t> result(Shape{x.rows(), y.columns()});
+        for (size_t i = 0; i < x.rows(); i++) {
+            for (size_t j = 0; j < y.columns(); j++) {
+                std::uint64_t sum = 0;
+                for (size_t k = 0; k < x.columns(); k++) {
+                    sum = (sum + x.get(i, k) * y.get(k, j) % modulus) % modulus;
+                }
+                result.get(i, j) = sum;
+            }
+        }
+        return result;
+    };
+    const std::uint64_t moduli[] = {1, 2, 97, 998244353, 1000000007, (1ULL << 32) - 5, 1ULL << 32};
+    // 260 is deeper than a KC block, so the residues are carried between the blocks
+    for (const size_t n : {37, 260}) {
+        Matrix<std::int64_t> x(Shape{n, n});
+        for (size_t i = 0; i < x.size(); i++) {
+            x[i] = static_cast<std::int64_t>(generator()) - static_cast<std::int64_t>(generator());
+        }
+        x[0] = INT64_MIN, x[1] = INT64_MAX;
+        for (const std::uint64_t modulus : moduli) {
+            if (n > 100 && modulus != 1000000007) { continue; }
+            Matrix<std::uint64_t> base(x.shape()), expected(x.shape(), IdentityMatrix());
+            for (size_t i = 0; i < x.size(); i++) {
+                // the residue of the magnitude, which is negated for the negative elements
+                const std::uint64_t magnitude = x[i] < 0 ? 0 - static_cast<std::uint64_t>(x[i])
+                                                         : static_cast<std::uint64_t>(x[i]);
+                base[i] = magnitude % modulus;
+                if (x[i] < 0 && base[i] != 0) { base[i] = modulus - base[i]; }
+            }
+            for (size_t i = 0; i < n; i++) { expected.get(i, i) %= modulus; }
+            Matrix<std::uint64_t> output(x.shape());
+            const size_t maxExponent = n > 100 ? 2 : 6;
+            for (size_t exponent = 0; exponent <= maxExponent; exponent++) {
+                powMod(x, exponent, modulus, output);
+                ASSERT_EQ(output, expected) << "modulus " << modulus << " exponent " << exponent;
+                if (exponent < maxExponent) {
+                    expected = exponent == 0 ? base : multiplyMod(expected, base, modulus);
+                }
+            }
+        }
+    }
+    // F(1000) overflows 64 bits, but its residue is exact
+    Matrix<std::int64_t> fibonacci(Shape{2, 2}, {1, 1, 1, 0});
+    const std::uint64_t modulus = 1000000007;
+    std::uint64_t previous      = 0, current = 1;
+    for (size_t i = 1; i < 1000; i++) {
+        const std::uint64_t next = (previous + current) % modulus;
+        previous                 = current, current = next;
+    }
+    Matrix<std::int32_t> power(fibonacci.shape());
+    powMod(fibonacci, 1000, modulus, power);
+    ASSERT_EQ(static_cast<std::uint64_t>(power.get(0, 1)), current);
+    // the in-place one and the one in a context are the same
+    Matrix<std::int64_t> same(fibonacci);
+    powMod(same, 1000, modulus);
+    ExecutionContext context(2);
+    Matrix<std::int64_t> inContext(fibonacci.shape());
+    powMod(context, fibonacci, 1000, modulus, inContext);
+    ASSERT_EQ(same, Matrix<std::int64_t>(power));
+    ASSERT_EQ(inContext, same);
+}
+
+TEST_F(TestMultiThreadCalculation, inPlaceAndOutputCalculation) {
+    init(THREAD_NUM);
+    Matrix<double> x(Shape{70, 90}), y(Shape{70, 90}), z(Shape{90, 70});
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<double>(i % 13), y[i] = static_cast<double>(i % 7 + 1);
+        z[i] = static_cast<double>(i % 5);
+    }
+    // the compound assignments write into the elements of a, which are never reallocated
+    Matrix<double> a(x);
+    const double *data = a.data();
+    a += y, a -= x, a *= 3, 3 *= a, a /= 9, 1 -= a, 2 += a, 4 /= a;
+    const Matrix<double> expected = 4 / (2 + (1 - y));
+    ASSERT_EQ(a.data(), data);
+    ASSERT_EQ(a, expected);
+    // the overloads with output write into the storage of the caller
+    Matrix<double> output(x.shape()), product(Shape{70, 70});
+    add(x, y, output);
+    ASSERT_EQ(output, x + y);
+    subtract(x, y, output);
+    ASSERT_EQ(output, x - y);
+    add(2, x, output);
+    ASSERT_EQ(output, 2 + x);
+    subtract(x, 2, output);
+    ASSERT_EQ(output, x - 2);
+    multiply(x, 2, output);
+    ASSERT_EQ(output, x * 2);
+    divide(2, y, output);
+    ASSERT_EQ(output, 2 / y);
+    const double *productData = product.data();
+    multiply(x, z, product);
+    ASSERT_EQ(product.data(), productData);
+    ASSERT_EQ(product, x * z);
+    // output may be an operand, and the integers are calculated in the common type
+    Matrix<double> square(Shape{70, 70}, 0.5);
+    const Matrix<double> squared = square * square;
+    multiply(square, square, square);
+    ASSERT_EQ(square, squared);
+    Matrix<int> integers(x.shape(), 3);
+    add(integers, y, integers);
+    subtract(integers, 0.5, integers);
+    ASSERT_EQ(integers, Matrix<int>(Matrix<double>(x.shape(), 3) + y - 0.5));
+}
+
+TEST_F(TestMultiThreadCalculation, rvalueOperands) {
+    init(THREAD_NUM);
+    Matrix<double> x(Shape{70, 90}), y(Shape{70, 90}), z(Shape{70, 90});
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<double>(i % 13), y[i] = static_cast<double>(i % 7 + 1);
+        z[i] = static_cast<double>(i % 5);
+    }
+    const Matrix<double> expected = 2 / ((1 - (x + y - z + 2.0) * 3) / 4 - 1);
+    // every step reuses the elements of the temporary matrix of x + y
+    Matrix<double> sum    = x + y;
+    const double *data    = sum.data();
+    Matrix<double> result = 2 / ((1 - (std::move(sum) - z + 2.0) * 3) / 4 - 1);
+    ASSERT_EQ(result.data(), data);
+    ASSERT_EQ(result, expected);
+    // the temporary matrix on the right side is reused too
+    Matrix<double> difference = y - z;
+    data                      = difference.data();
+    result                    = x - std::move(difference);
+    ASSERT_EQ(result.data(), data);
+    ASSERT_EQ(result, x - (y - z));
+    Matrix<double> left = x + 0.0, right = y + 0.0;
+    // only the right one has the common type
+    data   = right.data();
+    result = Matrix<int>(x) + std::move(right);
+    ASSERT_EQ(result.data(), data);
+    ASSERT_EQ(result, x + y);
+    result = std::move(left) - Matrix<double>(y);
+    ASSERT_EQ(result, x - y);
+    // a temporary matrix whose value_type is not the common type is not reused
+    ASSERT_EQ(Matrix<int>(y) / 2.0, y / 2);
+    ASSERT_EQ(Matrix<int>(x) - Matrix<double>(y), x - y);
+    ASSERT_EQ(Matrix<int>(x) + Matrix<int>(y), Matrix<int>(x + y));
+}
+
 TEST_F(TestMultiThreadCalculation, numberPowMatrix) {
     auto value = generator() % MAX_VALUE, number = generator() % MAX_VALUE;
 
@@ -1123,5 +1341,165 @@ TEST_F(TestMultiThreadCalculation, matrixSelfMultiplyNum) {
     // make sure they are equal
     ASSERT_EQ(singleOutput, multiOutput);
 }
+// the tall-skinny and the short-wide products are partitioned into 2D tiles
+TEST_F(TestMultiThreadCalculation, tiledMultiplication) {
+    const Shape shapes[][2] = {{Shape{2000, 50}, Shape{50, 8}}, {Shape{8, 50}, Shape{50, 3000}}};
+    for (const auto &shape : shapes) {
+        mulA = Matrix<double>(shape[0]);
+        mulB = Matrix<double>(shape[1]);
+        for (auto &element : mulA) { element = generator() % MAX_VALUE; }
+        for (auto &element : mulB) { element = generator() % MAX_VALUE; }
+        init(0);
+        singleOutput = mulA * mulB;
+        init(THREAD_NUM);
+        multiOutput = mulA * mulB;
+        ASSERT_EQ(singleOutput, multiOutput);
+
+        // the tiles cover the output without overlapping, and there are enough for the threads
+        Tiling tiling = gemmTiling<double>(shape[0].rows, shape[1].columns, 64);
+        ASSERT_GE(tiling.tileNum(), (size_t)64);
+        Matrix<int> covered(Shape{shape[0].rows, shape[1].columns}, 0);
+        size_t rowBegin = 0, rowEnd = 0, columnBegin = 0, columnEnd = 0;
+        for (size_t t = 0; t < tiling.tileNum(); t++) {
+            tiling.tile(t, rowBegin, rowEnd, columnBegin, columnEnd);
+            for (size_t i = rowBegin; i < rowEnd; i++) {
+                for (size_t j = columnBegin; j < columnEnd; j++) { covered.get(i, j)++; }
+            }
+        }
+        ASSERT_EQ(covered, Matrix<int>(covered.shape(), 1));
+    }
+}
+
+TEST_F(TestMultiThreadCalculation, narrowOutputMultiplication) {
+    // the depth spans several KC blocks, and the rows span several MC strips
+    const size_t depth = 3 * GemmBlocking<double>::KC + 7, rows = 2 * GemmBlocking<double>::MC + 5;
+    const Shape shapes[][2] = {{Shape{1, depth}, Shape{depth, 1}},
+                               {Shape{rows, depth}, Shape{depth, 9}}};
+    for (const auto &shape : shapes) {
+        mulA = Matrix<double>(shape[0], 0.3);
+        mulB = Matrix<double>(shape[1], 1.0);
+        for (size_t i = 0; i < mulA.size(); i++) { mulA[i] += static_cast<double>(i % 3) / 7; }
+        // the sum is converted to int once, not after every block
+        const Matrix<int> expected(mulA * mulB);
+        Matrix<int> output(expected.shape());
+        init(0);
+        multiply(mulA, mulB, output);
+        ASSERT_EQ(output, expected);
+        init(THREAD_NUM);
+        multiply(mulA, mulB, output);
+        ASSERT_EQ(output, expected);
+    }
+}
+
+// Strassen-Winograd with odd sides, compared with the ordinary multiplication
+TEST_F(TestMultiThreadCalculation, strassenMultiplication) {
+    const size_t side = 101;
+    Matrix<int> x(Shape{side, side}), y(Shape{side, side});
+    for (auto &element : x) { element = static_cast<int>(generator() % MAX_VALUE) - MAX_VALUE / 2; }
+    for (auto &element : y) { element = static_cast<int>(generator() % MAX_VALUE) - MAX_VALUE / 2; }
+    Matrix<double> z(y.shape());
+    for (auto &element : z) { element = static_cast<double>(generator() % MAX_VALUE) / 7; }
+
+    ExecutionContext ordinary(THREAD_NUM), single(0), multi(THREAD_NUM);
+    ordinary.setStrassenCrossover(0);
+    single.setStrassenCrossover(16);
+    multi.setStrassenCrossover(16);
+    Matrix<int> expected = ordinary.run([&]() { return x * y; });
+    ASSERT_EQ(single.run([&]() { return x * y; }), expected);
+    ASSERT_EQ(multi.run([&]() { return x * y; }), expected);
+
+    // the sums of the quarters overflow int, but the product does not
+    Matrix<int> large(x.shape());
+    for (size_t i = 0; i < large.size(); i++) {
+        const int magnitude = std::numeric_limits<int>::max() - static_cast<int>(i % MAX_VALUE);
+        large[i]            = i % 3 == 0 ? -magnitude : magnitude;
+    }
+    const Matrix<int> identity(large.shape(), IdentityMatrix());
+    ASSERT_EQ(multi.run([&]() { return large * identity; }), large);
+
+    // the floating-point products keep the ordinary multiplication by default
+    ASSERT_FALSE(multi.strassenFloatingPoint());
+    ASSERT_EQ(multi.run([&]() { return x * z; }), ordinary.run([&]() { return x * z; }));
+    // the floating-point result does not depend on the threads
+    single.setStrassenFloatingPoint(true);
+    multi.setStrassenFloatingPoint(true);
+    Matrix<double> strassen = single.run([&]() { return x * z; });
+    ASSERT_EQ(multi.run([&]() { return x * z; }), strassen);
+    multi.setEpsilon(1e-6);
+    ASSERT_TRUE(multi.run([&]() { return strassen == ordinary.run([&]() { return x * z; }); }));
+}
+
+TEST_F(TestMultiThreadCalculation, earlyExitComparison) {
+    auto value = generator() % MAX_VALUE;
+    a = b = Matrix<double>(squareShape, value);
+
+    init(THREAD_NUM);
+
+    ASSERT_TRUE(a == b);
+    ASSERT_FALSE(a != b);
+    // the first task gets the decisive result, and the others are cancelled
+    b.front() = value + 1;
+    ASSERT_FALSE(a == b);
+    ASSERT_FALSE(a < b);
+    ASSERT_TRUE(a <= b);
+    b.front() = value;
+    b.back()  = value + 1;
+    ASSERT_FALSE(a == b);
+    ASSERT_FALSE(b <= a);
+    // every element is different
+    b = a + 1.;
+    ASSERT_TRUE(a != b);
+    ASSERT_TRUE(a < b);
+}
+
+TEST_F(TestMultiThreadCalculation, concurrentCallers) {
+    constexpr size_t CALLER_NUM = 4, REPEAT_TIMES = 5;
+    auto value1 = generator() % MAX_VALUE, value2 = generator() % MAX_VALUE;
+
+    mulA = Matrix<double>(mul1Shape, value1);
+    mulB = Matrix<double>(mul2Shape, value2);
+    a    = Matrix<double>(mul1Shape, value2);
+
+    // the results in single-thread mode
+    Matrix<double> product = mulA * mulB, sum = mulA + a;
+
+    init(THREAD_NUM);
+
+    // many threads use the same thread pool at the same time
+    std::vector<std::thread> callers;
+    std::atomic<size_t> wrongResults{0};
+    for (size_t i = 0; i < CALLER_NUM; i++) {
+        callers.emplace_back([&]() {
+            for (size_t j = 0; j < REPEAT_TIMES; j++) {
+                if (!(mulA * mulB == product)) { wrongResults++; }
+                if (!(mulA + a == sum)) { wrongResults++; }
+            }
+        });
+    }
+    for (auto &caller : callers) { caller.join(); }
+
+    ASSERT_EQ(wrongResults.load(), (size_t)0);
+}
+
+TEST_F(TestMultiThreadCalculation, nestedCalculation) {
+    constexpr size_t TASK_NUM = 4;
+    auto value1 = generator() % MAX_VALUE, value2 = generator() % MAX_VALUE;
+
+    mulA = Matrix<double>(mul1Shape, value1);
+    mulB = Matrix<double>(mul2Shape, value2);
+
+    // the result in single-thread mode
+    Matrix<double> product = mulA * mulB;
+
+    init(THREAD_NUM);
+
+    // every task of the pool calculates with the same pool
+    std::atomic<size_t> wrongResults{0};
+    threadPool().parallelFor(TASK_NUM, [&](const size_t &) {
+        if (!(mulA * mulB == product)) { wrongResults++; }
+    });
+
+    ASSERT_EQ(wrongResults.load(), (size_t)0);
+}
 }  // namespace test
 }  // namespace mca
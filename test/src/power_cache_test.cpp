@@ -0,0 +1,69 @@
+#include "mca/power_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "mca/matrix.h"
+#include "mca/mca.h"
+
+namespace mca {
+namespace test {
+class TestPowerCache : public testing::Test {
+protected:
+    static constexpr size_t THREAD_NUM = 4;
+
+    void SetUp() override {
+        for (size_t i = 0; i < a.size(); i++) { a[i] = i % 5; }
+    }
+
+    void TearDown() override { init(0); }
+
+    // the unsigned powers wrap around, so they are the same in any order of the factors
+    Matrix<std::uint64_t> a{Shape(20, 20)};
+    const size_t squareBytes = 20 * 20 * sizeof(std::uint64_t);
+};
+
+TEST_F(TestPowerCache, powers) {
+    init(THREAD_NUM);
+    PowerCache<std::uint64_t> cache(a);
+    for (size_t exponent = 0; exponent <= 40; exponent++) {
+        ASSERT_EQ(cache.pow(exponent), a.pow(exponent));
+    }
+    // the squares of the bits of 40 are up to A^32
+    ASSERT_EQ(cache.cachedNum(), 5);
+    ASSERT_EQ(cache.memory(), 5 * squareBytes);
+    ASSERT_EQ(cache.pow(1000), a.pow(1000));
+    ASSERT_EQ(*cache.square(3), a.pow(8));
+    // the cache keeps its own copy
+    const Matrix<std::uint64_t> expected = a.pow(7);
+    a.fill(0);
+    ASSERT_EQ(cache.pow(7), expected);
+    cache.clear();
+    ASSERT_EQ(cache.cachedNum(), 0);
+    ASSERT_EQ(cache.memory(), 0);
+    ASSERT_EQ(cache.pow(7), expected);
+}
+
+TEST_F(TestPowerCache, leastRecentlyUsedEviction) {
+    PowerCache<std::uint64_t> cache(a, 2 * squareBytes);
+    ASSERT_EQ(cache.pow(16), a.pow(16));
+    ASSERT_EQ(cache.cachedNum(), 2);
+    ASSERT_TRUE(cache.cached(3) && cache.cached(4));
+    ASSERT_EQ(cache.pow(4), a.pow(4));
+    ASSERT_TRUE(cache.cached(1) && cache.cached(2));
+    ASSERT_LE(cache.memory(), cache.budget());
+    // A^2 is used after A^4 is cached, so A^4 is evicted first
+    cache.square(1);
+    cache.setBudget(squareBytes);
+    ASSERT_TRUE(cache.cached(1));
+    ASSERT_FALSE(cache.cached(2));
+    // without budget nothing is cached, but the powers are still right
+    cache.setBudget(0);
+    ASSERT_EQ(cache.cachedNum(), 0);
+    ASSERT_TRUE(cache.cached(0));
+    ASSERT_EQ(cache.pow(13), a.pow(13));
+    ASSERT_EQ(cache.memory(), 0);
+}
+}  // namespace test
+}  // namespace mca
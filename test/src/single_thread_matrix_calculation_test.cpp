@@ -2,8 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "mca/execution_context.h"
 #include "mca/matrix.h"
 
 namespace mca {
@@ -265,6 +273,231 @@ TEST_F(TestSingleThreadCalculation, multiplySubMatrix) {
     ASSERT_TRUE(equalSingleThread(output, result, 0, output.size()));
 }
 
+// the shapes are not multiples of the blocks, and the depth is larger than a block
+TEST_F(TestSingleThreadCalculation, multiplyBlocked) {
+    const size_t rows = 70, depth = 300, columns = 45;
+    Matrix<double> x(Shape{rows, depth}), y(Shape{depth, columns}), expected(Shape{rows, columns});
+    Matrix<int> z(Shape{depth, columns});
+    for (size_t i = 0; i < x.size(); i++) { x[i] = static_cast<double>(i % 7) - 3; }
+    for (size_t i = 0; i < y.size(); i++) {
+        y[i] = static_cast<double>(i % 5);
+        z[i] = static_cast<int>(i % 5);
+    }
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+            double sum = 0;
+            for (size_t k = 0; k < depth; k++) { sum += x.get(i, k) * y.get(k, j); }
+            expected.get(i, j) = sum;
+        }
+    }
+    Matrix<double> product(Shape{rows, columns}, -1);
+    multiplySingleThread(x, y, product, 0, product.size());
+    ASSERT_TRUE(equalSingleThread(product, expected, 0, product.size()));
+
+    // a range which starts and ends in the middle of the rows
+    product = Matrix<double>(Shape{rows, columns}, -1);
+    multiplySingleThread(x, z, product, 100, 2000);
+    for (size_t i = 0; i < product.size(); i++) {
+        ASSERT_EQ(product[i], i >= 100 && i < 2100 ? expected[i] : -1);
+    }
+
+    Matrix<float> floatProduct(Shape{rows, columns});
+    multiplySingleThread(x, z, floatProduct, 0, floatProduct.size());
+    for (size_t i = 0; i < floatProduct.size(); i++) {
+        ASSERT_EQ(floatProduct[i], static_cast<float>(expected[i]));
+    }
+}
+
+// the SIMD micro-kernels must calculate the same tiles with the portable one
+template <class T>
+void checkGemmKernel() {
+    constexpr size_t MR = GemmBlocking<T>::MR, NR = GemmBlocking<T>::NR, depth = 37;
+    std::vector<T> packedA(MR * depth), packedB(depth * NR), expected(MR * NR), tile(MR * NR);
+    for (size_t i = 0; i < packedA.size(); i++) { packedA[i] = static_cast<T>(i % 11) - 5; }
+    for (size_t i = 0; i < packedB.size(); i++) { packedB[i] = static_cast<T>(i % 13) - 6; }
+    gemmScalarKernel(depth, packedA.data(), packedB.data(), expected.data());
+    GemmKernel<T> kernel = gemmSimdKernel<T>();
+    if (kernel == nullptr) { return; }
+    kernel(depth, packedA.data(), packedB.data(), tile.data());
+    ASSERT_EQ(tile, expected);
+}
+
+TEST_F(TestSingleThreadCalculation, multiplySimdKernel) {
+    testing::Test::RecordProperty("InstructionSet", gemmInstructionSet());
+    checkGemmKernel<float>();
+    checkGemmKernel<double>();
+    checkGemmKernel<std::int32_t>();
+    checkGemmKernel<std::int64_t>();
+
+    // the unsigned integers use the kernels of the signed ones
+    Matrix<unsigned> x(Shape{9, 20}), y(Shape{20, 17}), product(Shape{9, 17});
+    for (size_t i = 0; i < x.size(); i++) { x[i] = static_cast<unsigned>(i * 2654435761u); }
+    for (size_t i = 0; i < y.size(); i++) { y[i] = static_cast<unsigned>(i * 40503u + 7); }
+    multiplySingleThread(x, y, product, 0, product.size());
+    for (size_t i = 0; i < x.rows(); i++) {
+        for (size_t j = 0; j < y.columns(); j++) {
+            unsigned sum = 0;
+            for (size_t k = 0; k < x.columns(); k++) { sum += x.get(i, k) * y.get(k, j); }
+            ASSERT_EQ(product.get(i, j), sum);
+        }
+    }
+
+    // the integers are mapped to the kernels by their width, not by the names of the types
+    static_assert(std::is_same_v<GemmSimdType<long long>::type, std::int64_t>);
+    static_assert(std::is_same_v<GemmSimdType<unsigned long long>::type, std::int64_t>);
+    static_assert(std::is_same_v<GemmSimdType<long>::type, std::int64_t> || sizeof(long) != 8);
+    static_assert(std::is_void_v<GemmSimdType<bool>::type>);
+    Matrix<long long> p(Shape{13, 29}), q(Shape{29, 11}), r(Shape{13, 11});
+    for (size_t i = 0; i < p.size(); i++) { p[i] = static_cast<long long>(i % 97) * 40503 - 1999; }
+    for (size_t i = 0; i < q.size(); i++) { q[i] = static_cast<long long>(i % 89) * 65537 - 2999; }
+    multiplySingleThread(p, q, r, 0, r.size());
+    for (size_t i = 0; i < p.rows(); i++) {
+        for (size_t j = 0; j < q.columns(); j++) {
+            long long sum = 0;
+            for (size_t k = 0; k < p.columns(); k++) { sum += p.get(i, k) * q.get(k, j); }
+            ASSERT_EQ(r.get(i, j), sum);
+        }
+    }
+}
+
+// the element-wise kernels peel the elements before the aligned ones, so the ranges start
+// anywhere, and every element must be the same as the one calculated in CommonType
+template <class T1, class T2, class O>
+void checkElementwiseSimd() {
+    using CommonType = std::common_type_t<T1, T2, O>;
+    Matrix<T1> x(Shape{7, 13});
+    Matrix<T2> y(Shape{7, 13});
+    Matrix<O> output(Shape{7, 13});
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<T1>(i % 17 + 1);
+        y[i] = static_cast<T2>(i % 5 + 2);
+    }
+    const T2 number    = static_cast<T2>(3);
+    const CommonType n = static_cast<CommonType>(number);
+    auto check         = [&](auto &&calculate, auto &&expect) {
+        for (const auto &range : {std::pair<size_t, size_t>{0, x.size()}, {3, 77}, {5, 2}}) {
+            std::fill(output.begin(), output.end(), O());
+            calculate(range.first, range.second);
+            for (size_t i = 0; i < output.size(); i++) {
+                const CommonType a = static_cast<CommonType>(x[i]);
+                const CommonType b = static_cast<CommonType>(y[i]);
+                const bool inRange = i >= range.first && i < range.first + range.second;
+                ASSERT_EQ(output[i], inRange ? static_cast<O>(expect(a, b)) : O());
+            }
+        }
+    };
+    check([&](size_t pos, size_t len) { addSingleThread(x, y, output, pos, len); },
+          [](CommonType a, CommonType b) { return a + b; });
+    check([&](size_t pos, size_t len) { subtractSingleThread(x, y, output, pos, len); },
+          [](CommonType a, CommonType b) { return a - b; });
+    check([&](size_t pos, size_t len) { addSingleThread(number, x, output, pos, len); },
+          [&n](CommonType a, CommonType) { return n + a; });
+    check([&](size_t pos, size_t len) { subtractSingleThread(number, x, output, pos, len); },
+          [&n](CommonType a, CommonType) { return n - a; });
+    check([&](size_t pos, size_t len) { subtractSingleThread(x, number, output, pos, len); },
+          [&n](CommonType a, CommonType) { return a - n; });
+    check([&](size_t pos, size_t len) { multiplySingleThread(number, x, output, pos, len); },
+          [&n](CommonType a, CommonType) { return a * n; });
+    check([&](size_t pos, size_t len) { divideSingleThread(x, number, output, pos, len); },
+          [&n](CommonType a, CommonType) { return a / n; });
+    check([&](size_t pos, size_t len) { divideSingleThread(number, x, output, pos, len); },
+          [&n](CommonType a, CommonType) { return n / a; });
+}
+
+TEST_F(TestSingleThreadCalculation, elementwiseSimdKernel) {
+    checkElementwiseSimd<float, float, float>();
+    checkElementwiseSimd<double, double, double>();
+    checkElementwiseSimd<int, int, int>();
+    checkElementwiseSimd<unsigned, int, unsigned>();
+    checkElementwiseSimd<std::int64_t, std::int64_t, std::int64_t>();
+    // the widening kernels, and the types without kernels
+    checkElementwiseSimd<int, double, double>();
+    checkElementwiseSimd<float, double, double>();
+    checkElementwiseSimd<int, int, double>();
+    checkElementwiseSimd<short, short, short>();
+}
+
+// check every comparison of x and y in the ranges with the element by element ones
+template <class T1, class T2>
+void checkComparisons(const Matrix<T1> &x, const Matrix<T2> &y) {
+    using CommonType = std::common_type_t<T1, T2>;
+    const double eps = epsilon();
+    for (const auto &range : {std::pair<size_t, size_t>{0, x.size()}, {3, 77}, {5, 2}}) {
+        auto expect = [&](auto &&compare) {
+            for (size_t i = range.first; i < range.first + range.second; i++) {
+                if (!compare(static_cast<CommonType>(x[i]), static_cast<CommonType>(y[i]))) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        const size_t pos = range.first, len = range.second;
+        ASSERT_EQ(equalSingleThread(x, y, pos, len), expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::EQUAL>(a, b, eps);
+                  }));
+        ASSERT_EQ(notEqualSingleThread(x, y, pos, len), expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::NOT_EQUAL>(a, b, eps);
+                  }));
+        ASSERT_EQ(lessSingleThread(x, y, pos, len), expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::LESS>(a, b, eps);
+                  }));
+        ASSERT_EQ(lessEqualSingleThread(x, y, pos, len), expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::LESS_EQUAL>(a, b, eps);
+                  }));
+        ASSERT_EQ(greaterSingleThread(x, y, pos, len), expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::GREATER>(a, b, eps);
+                  }));
+        ASSERT_EQ(greaterEqualSingleThread(x, y, pos, len),
+                  expect([&eps](CommonType a, CommonType b) {
+                      return compareElements<ComparisonOperator::GREATER_EQUAL>(a, b, eps);
+                  }));
+    }
+}
+
+// the comparison kernels test the masks of the vectors once, so one element out of the order
+// must be found in a vector or after the last one, and the differences around epsilon(), which
+// is not a float, must be compared like the element by element comparisons
+template <class T1, class T2>
+void checkComparisonSimd(const std::vector<T2> &deltas) {
+    Matrix<T1> x(Shape{7, 13});
+    Matrix<T2> y(Shape{7, 13}), z(Shape{7, 13});
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<T1>(i % 17);
+        y[i] = static_cast<T2>(x[i]);
+        z[i] = static_cast<T2>(y[i] + 1);
+    }
+    checkComparisons(x, y);
+    checkComparisons(x, z);
+    checkComparisons(z, x);
+    // x is 0 at p, so that x - y is exactly -delta
+    for (const size_t p : {0, 34, 85}) {
+        for (const T2 &delta : deltas) {
+            y[p] = static_cast<T2>(x[p] + delta);
+            z[p] = static_cast<T2>(x[p] + delta);
+            checkComparisons(x, y);
+            checkComparisons(x, z);
+            checkComparisons(z, x);
+            y[p] = static_cast<T2>(x[p]);
+            z[p] = static_cast<T2>(x[p] + 1);
+        }
+    }
+}
+
+TEST_F(TestSingleThreadCalculation, comparisonSimdKernel) {
+    ExecutionContext context(1, 10, 0.1);
+    ScopedExecutionContext scope(context);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    checkComparisonSimd<float, float>({0.1f, std::nextafter(0.1f, 0.f), -0.1f, 0.05f, -1.f, nan});
+    checkComparisonSimd<double, double>({0.1, std::nextafter(0.1, 0.), -0.1, 0.05, -1., nan});
+    checkComparisonSimd<float, double>({0.1, -0.1, 0.05, -1.});
+    checkComparisonSimd<int, int>({-1, 1, -20});
+    checkComparisonSimd<unsigned, unsigned>({1, 0x80000000u, 0xFFFFFFF0u});
+    checkComparisonSimd<int, unsigned>({1, 0x80000000u});
+    checkComparisonSimd<std::int64_t, std::int64_t>({-1, 1, INT64_MIN / 2});
+    checkComparisonSimd<std::uint64_t, std::uint64_t>({1, 0x8000000000000000u});
+    checkComparisonSimd<short, short>({-1, 1});
+}
+
 TEST_F(TestSingleThreadCalculation, transposeWholeMatrix) {
     output = Matrix<double>(Shape{3, 3}, 0);
     transposeSingleThread(c, output, 0, c.size());
@@ -279,6 +512,32 @@ TEST_F(TestSingleThreadCalculation, transposeSubMatrix) {
     ASSERT_TRUE(equalSingleThread(output, result, 0, output.size()));
 }
 
+// the shapes are not multiples of the tiles or the blocks, and the ranges start in a row
+template <class T>
+void checkTransposeBlocked() {
+    const size_t rows = 77, columns = 141;
+    Matrix<T> x(Shape{rows, columns}), output(Shape{columns, rows});
+    for (size_t i = 0; i < x.size(); i++) { x[i] = static_cast<T>(i * 2654435761u % 1000003); }
+    for (const auto &range : {std::pair<size_t, size_t>{0, x.size()}, {5, 1000}, {300, 4}}) {
+        std::fill(output.begin(), output.end(), T());
+        transposeSingleThread(x, output, range.first, range.second);
+        for (size_t t = 0; t < output.size(); t++) {
+            const size_t i = t / rows, j = t % rows;
+            const T value  = t >= range.first && t < range.first + range.second ? x.get(j, i) : T();
+            ASSERT_EQ(output[t], value);
+        }
+    }
+}
+
+TEST_F(TestSingleThreadCalculation, transposeBlocked) {
+    checkTransposeBlocked<std::int8_t>();
+    checkTransposeBlocked<float>();
+    checkTransposeBlocked<std::int32_t>();
+    checkTransposeBlocked<double>();
+    checkTransposeBlocked<std::uint64_t>();
+    checkTransposeBlocked<long double>();
+}
+
 TEST_F(TestSingleThreadCalculation, symmetricWholeMatrix) {
     ASSERT_TRUE(symmetricSingleThread(sym, 0, sym.size()));
     ASSERT_FALSE(symmetricSingleThread(antisym, 0, antisym.size()));
@@ -299,5 +558,43 @@ TEST_F(TestSingleThreadCalculation, antisymmetricSubMatrix) {
     ASSERT_FALSE(antisymmetricSingleThread(sym, 0, 2));
 }
 
+// every position of the strict upper triangle is checked by exactly one pair of the blocks
+TEST_F(TestSingleThreadCalculation, symmetricBlockPairs) {
+    const size_t side    = 131;
+    const size_t pairNum = transposeBlockPairs<double>(side).pairNum(), half = pairNum / 2;
+    Matrix<double> x(Shape{side, side}), y(Shape{side, side});
+    for (size_t i = 0; i < side; i++) {
+        for (size_t j = 0; j <= i; j++) {
+            x.get(i, j) = x.get(j, i) = static_cast<double>(i * side + j);
+            y.get(i, j)               = static_cast<double>(i * side + j);
+            y.get(j, i)               = -y.get(i, j);
+        }
+        y.get(i, i) = 1;
+    }
+    ASSERT_TRUE(symmetricBlockPairsSingleThread(x, 0, pairNum));
+    ASSERT_TRUE(antisymmetricBlockPairsSingleThread(y, 0, pairNum));
+    ASSERT_FALSE(symmetricBlockPairsSingleThread(y, 0, pairNum));
+    for (const auto &position : {std::pair<size_t, size_t>{0, 1}, {5, 130}, {64, 70}, {129, 130}}) {
+        const size_t i = position.first, j = position.second;
+        for (bool upper : {true, false}) {
+            Matrix<double> z = x;
+            (upper ? z.get(i, j) : z.get(j, i)) += 1;
+            ASSERT_FALSE(symmetricBlockPairsSingleThread(z, 0, pairNum));
+            ASSERT_NE(symmetricBlockPairsSingleThread(z, 0, half),
+                      symmetricBlockPairsSingleThread(z, half, pairNum - half));
+        }
+    }
+}
+
+
+TEST_F(TestSingleThreadCalculation, cancelledCheck) {
+    std::atomic<bool> stop{false};
+    ASSERT_TRUE(equalSingleThread(a, d, 0, a.size(), &stop));
+    ASSERT_TRUE(symmetricSingleThread(sym, 0, sym.size(), &stop));
+    // the checks give up once stop is set
+    stop = true;
+    ASSERT_FALSE(equalSingleThread(a, d, 0, a.size(), &stop));
+    ASSERT_FALSE(symmetricSingleThread(sym, 0, sym.size(), &stop));
+}
 }  // namespace test
-}  // namespace mca
\ No newline at end of file
+}  // namespace mca
@@ -55,5 +55,213 @@ TEST(TestThreadPool, clear) {
     tp.clear();
 }
 
+// this test will check if the tasks behind a blocked task can be stolen by other threads
+TEST(TestThreadPool, workStealing) {
+    using namespace std::chrono_literals;
+    ThreadPool &tp = ThreadPool::getInstance(2);
+    std::promise<void> unblock;
+    auto unblocked = unblock.get_future();
+    std::vector<std::future<bool>> resultVector;
+    // the first task blocks its thread until the last task finishes
+    resultVector.emplace_back(tp.addTask(
+        [&unblocked]() { return unblocked.wait_for(2s) == std::future_status::ready; }));
+    size_t taskNum = 10;
+    for (size_t i = 0; i < taskNum; i++) {
+        resultVector.emplace_back(tp.addTask([]() { return true; }));
+    }
+    for (size_t i = 1; i < resultVector.size(); i++) { ASSERT_TRUE(resultVector[i].get()); }
+    unblock.set_value();
+    ASSERT_TRUE(resultVector[0].get());
+    tp.clear();
+}
+
+// this test will check if many threads can add tasks to the same thread pool at the same time
+TEST(TestThreadPool, addTaskFromManyThreads) {
+    ThreadPool &tp     = ThreadPool::getInstance(3);
+    size_t producerNum = 8;
+    size_t taskNum     = 1000;
+    std::atomic<size_t> sum{0};
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producerNum; i++) {
+        producers.emplace_back([&tp, &sum, taskNum]() {
+            std::vector<std::future<void>> resultVector;
+            for (size_t j = 0; j < taskNum; j++) {
+                resultVector.emplace_back(tp.addTask([&sum, j]() { sum += j; }));
+            }
+            for (auto &result : resultVector) { result.get(); }
+        });
+    }
+    for (auto &producer : producers) { producer.join(); }
+    ASSERT_EQ(sum.load(), producerNum * taskNum * (taskNum - 1) / 2);
+    tp.clear();
+}
+
+// this test will check if the tasks queued in the retired threads are still run
+TEST(TestThreadPool, shrinkKeepsTasks) {
+    using namespace std::chrono_literals;
+    ThreadPool &tp = ThreadPool::getInstance(4);
+    size_t taskNum = 100;
+    std::atomic<size_t> count{0};
+    std::vector<std::future<void>> resultVector;
+    for (size_t i = 0; i < taskNum; i++) {
+        resultVector.emplace_back(tp.addTask([&count]() {
+            std::this_thread::sleep_for(1ms);
+            count++;
+        }));
+    }
+    tp.resize(1);
+    ASSERT_EQ(tp.size(), (size_t)1);
+    for (auto &result : resultVector) { result.get(); }
+    ASSERT_EQ(count.load(), taskNum);
+    // the retired threads are replaced when the thread pool grows again
+    tp.resize(3);
+    ASSERT_EQ(tp.size(), (size_t)3);
+    ASSERT_EQ(tp.addTask([]() -> size_t { return 233; }).get(), (size_t)233);
+    tp.clear();
+}
+
+// this test will check if the thread pool can be resized while other threads are adding tasks
+TEST(TestThreadPool, resizeWhileAddingTasks) {
+    ThreadPool &tp     = ThreadPool::getInstance(2);
+    size_t producerNum = 4;
+    size_t taskNum     = 2000;
+    std::atomic<size_t> sum{0};
+    std::atomic<bool> producing{true};
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producerNum; i++) {
+        producers.emplace_back([&tp, &sum, taskNum]() {
+            std::vector<std::future<void>> resultVector;
+            for (size_t j = 0; j < taskNum; j++) {
+                resultVector.emplace_back(tp.addTask([&sum, j]() { sum += j; }));
+            }
+            for (auto &result : resultVector) { result.get(); }
+        });
+    }
+    std::thread resizer([&tp, &producing]() {
+        size_t sizes[] = {5, 1, 3, 8, 2, 4};
+        for (size_t k = 0; producing.load(); k = (k + 1) % std::size(sizes)) {
+            tp.resize(sizes[k]);
+            std::this_thread::yield();
+        }
+    });
+    for (auto &producer : producers) { producer.join(); }
+    producing = false;
+    resizer.join();
+    ASSERT_EQ(sum.load(), producerNum * taskNum * (taskNum - 1) / 2);
+    tp.clear();
+}
+
+TEST(TestThreadPool, parallelFor) {
+    ThreadPool &tp = ThreadPool::getInstance(3);
+    size_t taskNum = 100;
+    std::vector<size_t> visited(taskNum, 0);
+    tp.parallelFor(taskNum, [&visited](const size_t &i) { visited[i]++; });
+    for (size_t i = 0; i < taskNum; i++) { ASSERT_EQ(visited[i], (size_t)1); }
+    // nothing happens when there is no task
+    tp.parallelFor(0, [](const size_t &) { FAIL(); });
+    // the exception will be thrown in the calling thread
+    ASSERT_THROW(tp.parallelFor(taskNum,
+                                [](const size_t &i) {
+                                    if (i == 50) { throw std::runtime_error("error"); }
+                                }),
+                 std::runtime_error);
+    tp.clear();
+    // the calling thread calculates all when the thread pool is empty
+    tp.parallelFor(taskNum, [&visited](const size_t &i) { visited[i]++; });
+    for (size_t i = 0; i < taskNum; i++) { ASSERT_EQ(visited[i], (size_t)2); }
+}
+
+TEST(TestThreadPool, parallelReduce) {
+    ThreadPool &tp = ThreadPool::getInstance(3);
+    size_t taskNum = 100;
+    auto sum       = tp.parallelReduce(
+        taskNum, (size_t)0, [](const size_t &i) { return i; }, std::plus<size_t>());
+    ASSERT_EQ(sum, taskNum * (taskNum - 1) / 2);
+    auto allLess = tp.parallelReduce(
+        taskNum, true, [taskNum](const size_t &i) { return i < taskNum; }, std::logical_and<>());
+    ASSERT_TRUE(allLess);
+    auto anyZero = tp.parallelReduce(
+        taskNum, false, [](const size_t &i) { return i == 0; }, std::logical_or<>());
+    ASSERT_TRUE(anyZero);
+    tp.clear();
+}
+
+// this test will check if parallelFor returns when the threads of the pool are busy,
+// the caller calculates all the indices, and does not wait for the helpers queued behind
+TEST(TestThreadPool, parallelForInBusyPool) {
+    using namespace std::chrono;
+    ThreadPool &tp = ThreadPool::getInstance(2);
+    std::atomic<bool> released{false};
+    std::atomic<size_t> started{0};
+    std::vector<std::future<void>> busy;
+    for (size_t k = 0; k < tp.size(); k++) {
+        busy.emplace_back(tp.addTask([&released, &started]() {
+            started++;
+            const auto deadline = steady_clock::now() + seconds(10);
+            while (!released && steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(milliseconds(1));
+            }
+        }));
+    }
+    while (started != tp.size()) { std::this_thread::yield(); }
+    size_t taskNum = 100;
+    std::vector<size_t> visited(taskNum, 0);
+    const auto startTime = steady_clock::now();
+    tp.parallelFor(taskNum, [&visited](const size_t &i) { visited[i]++; });
+    ASSERT_LT(steady_clock::now() - startTime, seconds(5));
+    for (size_t i = 0; i < taskNum; i++) { ASSERT_EQ(visited[i], (size_t)1); }
+    // the stale helpers run after parallelFor returns, and claim nothing
+    released = true;
+    for (auto &future : busy) { future.get(); }
+    tp.parallelFor(taskNum, [&visited](const size_t &i) { visited[i]++; });
+    for (size_t i = 0; i < taskNum; i++) { ASSERT_EQ(visited[i], (size_t)2); }
+    tp.clear();
+}
+
+// this test will check if parallelFor can be called in the tasks of the same thread pool
+// a thread of the pool only waits for the indices which are claimed, never for the queued tasks
+TEST(TestThreadPool, nestedParallelFor) {
+    ThreadPool &tp = ThreadPool::getInstance(2);
+    size_t taskNum = 8;
+    std::atomic<size_t> sum{0};
+    tp.parallelFor(taskNum, [&tp, &sum, taskNum](const size_t &) {
+        tp.parallelFor(taskNum, [&tp, &sum, taskNum](const size_t &) {
+            tp.parallelFor(taskNum, [&sum](const size_t &i) { sum += i; });
+        });
+    });
+    ASSERT_EQ(sum.load(), taskNum * taskNum * taskNum * (taskNum - 1) / 2);
+    // the tasks added by addTask() can also call parallelFor
+    auto result = tp.addTask([&tp, taskNum]() {
+        return tp.parallelReduce(
+            taskNum, (size_t)0, [](const size_t &i) { return i; }, std::plus<size_t>());
+    });
+    ASSERT_EQ(result.get(), taskNum * (taskNum - 1) / 2);
+    // the threads which do not belong to the pool do not run the tasks
+    ASSERT_FALSE(tp.runPendingTask());
+    tp.clear();
+}
+
+// this test will record the average time between adding a task and the task starting,
+// a sleeping thread is woken in microseconds, so the bound only catches the polling regressions
+TEST(TestThreadPool, submitToStartLatency) {
+    using namespace std::chrono;
+    ThreadPool &tp = ThreadPool::getInstance(4);
+    size_t taskNum = 200;
+    // let the threads fall asleep
+    std::this_thread::sleep_for(milliseconds(10));
+    nanoseconds totalLatency{0};
+    for (size_t i = 0; i < taskNum; i++) {
+        auto submitTime = high_resolution_clock::now();
+        auto startTime  = tp.addTask([]() { return high_resolution_clock::now(); }).get();
+        totalLatency += duration_cast<nanoseconds>(startTime - submitTime);
+    }
+    const nanoseconds averageLatency = totalLatency / taskNum;
+    testing::Test::RecordProperty(
+        "AverageLatencyMicroseconds",
+        static_cast<int>(duration_cast<microseconds>(averageLatency).count()));
+    ASSERT_LT(averageLatency, milliseconds(1));
+    tp.clear();
+}
+
 }  // namespace test
 }  // namespace mca